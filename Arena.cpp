@@ -0,0 +1,345 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr int DX[] = {0, 0, -1, 1};  // 按 Direction 顺序：UP, DOWN, LEFT, RIGHT
+constexpr int DY[] = {-1, 1, 0, 0};
+constexpr int TARGET_SAMPLES = 4;    // AI 换目标时随机看几个食物，取最近的
+
+bool isOpposite(std::uint8_t a, std::uint8_t b) {
+    return (a ^ 1) == b;  // UP/DOWN、LEFT/RIGHT 的编号只差最低位
+}
+
+// splitmix64 的混合函数：AI 选目标时按（种子, 蛇, 帧）取样，不依赖共享的随机数状态，
+// 转向阶段因此与蛇的处理顺序无关
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+Arena::Arena(const ArenaConfig& cfg)
+    : config(cfg),
+      width(cfg.board.width),
+      snakeCount(0),
+      aliveCount(0),
+      tick(0),
+      rng(cfg.seed),
+      freeCells(static_cast<int>(cfg.board.cellCount())),
+      foodCells(static_cast<int>(cfg.board.cellCount())) {
+    int cells = static_cast<int>(config.board.cellCount());
+    config.snakeCount = std::max(1, std::min({config.snakeCount, MAX_SNAKES, cells / 8}));
+    config.humanCount = std::max(0, std::min(config.humanCount, config.snakeCount));
+    config.foodCount = std::max(0, std::min(config.foodCount, cells / 4));
+    config.initialLength = std::max(1, config.initialLength);
+    config.growth = std::max(0, config.growth);
+    config.respawnTicks = std::max(0, config.respawnTicks);
+    snakeCount = config.snakeCount;
+
+    std::size_t n = static_cast<std::size_t>(snakeCount);
+    heads.assign(n, EMPTY);
+    tails.assign(n, EMPTY);
+    lengths.assign(n, 0);
+    pendingGrowth.assign(n, 0);
+    scores.assign(n, 0);
+    deaths.assign(n, 0);
+    targets.assign(n, EMPTY);
+    nextHeads.assign(n, EMPTY);
+    directions.assign(n, static_cast<std::uint8_t>(Direction::RIGHT));
+    inputs.assign(n, static_cast<std::uint8_t>(Direction::RIGHT));
+    alive.assign(n, 0);
+    killed.assign(n, 0);
+    respawnAt.assign(n, 0);
+
+    std::size_t cellCount = config.board.cellCount();
+    occupant.assign(cellCount, EMPTY);
+    towardHead.assign(cellCount, EMPTY);
+    claims.assign(cellCount, EMPTY);
+    food.assign(cellCount, 0);
+    for (int cell = 0; cell < cells; ++cell) {
+        freeCells.insert(cell);
+    }
+
+    for (int i = 0; i < snakeCount; ++i) {
+        spawn(i);
+    }
+    spawnFood();
+}
+
+void Arena::setDirection(int snake, Direction direction) {
+    if (snake < 0 || snake >= snakeCount) return;
+    inputs[snake] = static_cast<std::uint8_t>(direction);
+}
+
+bool Arena::placeSnake(int snake, const std::vector<std::pair<int, int>>& body, Direction direction) {
+    if (snake < 0 || snake >= snakeCount || body.empty()) return false;
+    // 借用 claims 标记已检查的格子以发现重复的节，检查完还原
+    bool valid = true;
+    std::size_t checked = 0;
+    for (; checked < body.size() && valid; ++checked) {
+        const auto& segment = body[checked];
+        if (!config.board.contains(segment.first, segment.second)) {
+            valid = false;
+            break;
+        }
+        std::int32_t cell = config.board.index(segment.first, segment.second);
+        std::int32_t owner = occupant[cell];
+        valid = (owner == EMPTY || owner == snake) && claims[cell] == EMPTY &&
+                (checked == 0 || std::abs(segment.first - body[checked - 1].first) +
+                                 std::abs(segment.second - body[checked - 1].second) == 1);
+        if (valid) claims[cell] = snake;
+    }
+    for (std::size_t i = 0; i < checked; ++i) {
+        if (config.board.contains(body[i].first, body[i].second)) {
+            std::int32_t cell = config.board.index(body[i].first, body[i].second);
+            if (claims[cell] == snake) claims[cell] = EMPTY;
+        }
+    }
+    if (!valid) return false;
+    removeSnake(snake);
+
+    // 从蛇尾到蛇头依次占据，链接指向蛇头方向
+    std::int32_t previous = EMPTY;
+    for (std::size_t i = body.size(); i-- > 0;) {
+        std::int32_t cell = config.board.index(body[i].first, body[i].second);
+        if (food[cell]) {
+            food[cell] = 0;
+            foodCells.erase(cell);
+        }
+        freeCells.erase(cell);
+        occupant[cell] = snake;
+        towardHead[cell] = EMPTY;
+        if (previous != EMPTY) towardHead[previous] = cell;
+        previous = cell;
+    }
+    heads[snake] = config.board.index(body.front().first, body.front().second);
+    tails[snake] = config.board.index(body.back().first, body.back().second);
+    lengths[snake] = static_cast<std::int32_t>(body.size());
+    pendingGrowth[snake] = 0;
+    targets[snake] = EMPTY;
+    directions[snake] = static_cast<std::uint8_t>(direction);
+    inputs[snake] = directions[snake];
+    alive[snake] = 1;
+    ++aliveCount;
+    return true;
+}
+
+void Arena::removeSnake(int snake) {
+    if (!alive[snake]) return;
+    for (std::int32_t cell = tails[snake];;) {
+        std::int32_t next = towardHead[cell];
+        occupant[cell] = EMPTY;
+        towardHead[cell] = EMPTY;
+        freeCells.insert(cell);
+        if (cell == heads[snake]) break;
+        cell = next;
+    }
+    alive[snake] = 0;
+    --aliveCount;
+}
+
+bool Arena::placeFood(int x, int y) {
+    if (!config.board.contains(x, y)) return false;
+    std::int32_t cell = config.board.index(x, y);
+    if (occupant[cell] != EMPTY || food[cell]) return false;
+    freeCells.erase(cell);
+    food[cell] = 1;
+    foodCells.insert(cell);
+    return true;
+}
+
+void Arena::update() {
+    ++tick;
+    steer();
+    advanceHeads();
+    resolveCollisions();
+    applyMoves();
+    spawnFood();
+    respawn();
+}
+
+std::int32_t Arena::neighbor(std::int32_t cell, Direction direction) const {
+    int d = static_cast<int>(direction);
+    int x = cell % width + DX[d];
+    int y = cell / width + DY[d];
+    return config.board.contains(x, y) ? config.board.index(x, y) : EMPTY;
+}
+
+bool Arena::isBlocked(std::int32_t cell) const {
+    std::int32_t owner = occupant[cell];
+    if (owner == EMPTY) return false;
+    // 本帧不生长的蛇会让出蛇尾，可以跟进
+    return !(cell == tails[owner] && pendingGrowth[owner] == 0);
+}
+
+bool Arena::spawn(int snake) {
+    if (freeCells.empty()) return false;
+    std::int32_t cell = freeCells.at(rng.uniform(static_cast<std::uint32_t>(freeCells.size())));
+    freeCells.erase(cell);
+    occupant[cell] = snake;
+    towardHead[cell] = EMPTY;
+    heads[snake] = cell;
+    tails[snake] = cell;
+    lengths[snake] = 1;
+    pendingGrowth[snake] = config.initialLength - 1;
+    targets[snake] = EMPTY;
+    alive[snake] = 1;
+    ++aliveCount;
+
+    // 朝离墙最远的方向出发
+    int x = cell % width;
+    int y = cell / width;
+    int room[] = {y, config.board.height - 1 - y, x, width - 1 - x};
+    int best = static_cast<int>(std::max_element(room, room + 4) - room);
+    directions[snake] = static_cast<std::uint8_t>(best);
+    inputs[snake] = directions[snake];
+    return true;
+}
+
+void Arena::steer() {
+    for (int i = 0; i < snakeCount; ++i) {
+        if (!alive[i]) continue;
+
+        if (isHuman(i)) {
+            if (lengths[i] == 1 || !isOpposite(inputs[i], directions[i])) directions[i] = inputs[i];
+            continue;
+        }
+
+        // 目标被吃掉后换一个：取样几个食物，选曼哈顿距离最近的
+        std::int32_t head = heads[i];
+        int hx = head % width;
+        int hy = head / width;
+        if ((targets[i] == EMPTY || !food[targets[i]]) && !foodCells.empty()) {
+            int bestDistance = -1;
+            std::uint64_t h = config.seed ^ (static_cast<std::uint64_t>(i) << 32) ^ tick;
+            for (int s = 0; s < TARGET_SAMPLES; ++s) {
+                h = mix(h);
+                std::int32_t candidate = foodCells.at(static_cast<std::size_t>(h % foodCells.size()));
+                int distance = std::abs(candidate % width - hx) + std::abs(candidate / width - hy);
+                if (bestDistance < 0 || distance < bestDistance) {
+                    bestDistance = distance;
+                    targets[i] = candidate;
+                }
+            }
+        }
+
+        // 在不会立即撞上的方向中选离目标最近的，距离相同时保持原方向；都不安全时不转向
+        std::int32_t target = targets[i];
+        int bestDistance = -1;
+        std::uint8_t best = directions[i];
+        for (int k = 0; k < 4; ++k) {
+            std::uint8_t d = static_cast<std::uint8_t>((directions[i] + k) & 3);
+            if (lengths[i] > 1 && isOpposite(d, directions[i])) continue;
+            std::int32_t cell = neighbor(head, static_cast<Direction>(d));
+            if (cell == EMPTY || isBlocked(cell)) continue;
+            int distance = target == EMPTY ? 0
+                : std::abs(target % width - cell % width) + std::abs(target / width - cell / width);
+            if (bestDistance < 0 || distance < bestDistance) {
+                bestDistance = distance;
+                best = d;
+            }
+        }
+        directions[i] = best;
+    }
+}
+
+void Arena::advanceHeads() {
+    for (int i = 0; i < snakeCount; ++i) {
+        nextHeads[i] = alive[i] ? neighbor(heads[i], static_cast<Direction>(directions[i])) : EMPTY;
+    }
+}
+
+void Arena::resolveCollisions() {
+    // 撞墙或撞上蛇身：只看新蛇头所在的一格
+    for (int i = 0; i < snakeCount; ++i) {
+        killed[i] = 0;
+        if (!alive[i]) continue;
+        std::int32_t cell = nextHeads[i];
+        if (cell == EMPTY || isBlocked(cell)) {
+            killed[i] = 1;
+            continue;
+        }
+        // 两条长度为 1 的蛇互换位置时都把对方的格子当作让出的蛇尾，需要单独按头对头处理
+        std::int32_t other = occupant[cell];
+        if (other != EMPTY && other != i && cell == heads[other] && nextHeads[other] == heads[i]) killed[i] = 1;
+    }
+
+    // 头对头：两条蛇要进入同一格时都死亡
+    for (int i = 0; i < snakeCount; ++i) {
+        std::int32_t cell = nextHeads[i];
+        if (!alive[i] || cell == EMPTY) continue;
+        std::int32_t other = claims[cell];
+        if (other == EMPTY) {
+            claims[cell] = i;
+        } else {
+            killed[i] = 1;
+            killed[other] = 1;
+        }
+    }
+    for (int i = 0; i < snakeCount; ++i) {
+        if (alive[i] && nextHeads[i] != EMPTY) claims[nextHeads[i]] = EMPTY;
+    }
+}
+
+void Arena::applyMoves() {
+    // 先移除死亡的蛇并让出蛇尾，再放置新蛇头：新蛇头可能正是别的蛇刚让出的格子
+    for (int i = 0; i < snakeCount; ++i) {
+        if (!alive[i]) continue;
+
+        if (killed[i]) {
+            removeSnake(i);
+            ++deaths[i];
+            respawnAt[i] = tick + static_cast<std::uint64_t>(config.respawnTicks);
+            continue;
+        }
+
+        if (pendingGrowth[i] > 0) {
+            --pendingGrowth[i];
+            ++lengths[i];
+            continue;
+        }
+
+        std::int32_t tail = tails[i];
+        tails[i] = lengths[i] == 1 ? nextHeads[i] : towardHead[tail];
+        occupant[tail] = EMPTY;
+        towardHead[tail] = EMPTY;
+        freeCells.insert(tail);
+    }
+
+    for (int i = 0; i < snakeCount; ++i) {
+        if (!alive[i]) continue;
+        std::int32_t cell = nextHeads[i];
+        if (food[cell]) {
+            food[cell] = 0;
+            foodCells.erase(cell);
+            pendingGrowth[i] += config.growth;
+            ++scores[i];
+        }
+        freeCells.erase(cell);
+        occupant[cell] = i;
+        towardHead[cell] = EMPTY;
+        if (occupant[heads[i]] == i) towardHead[heads[i]] = cell;  // 长度为 1 且未生长时旧蛇头已让出
+        heads[i] = cell;
+    }
+}
+
+void Arena::spawnFood() {
+    while (foodCells.size() < static_cast<std::size_t>(config.foodCount) && !freeCells.empty()) {
+        std::int32_t cell = freeCells.at(rng.uniform(static_cast<std::uint32_t>(freeCells.size())));
+        freeCells.erase(cell);
+        food[cell] = 1;
+        foodCells.insert(cell);
+    }
+}
+
+void Arena::respawn() {
+    if (config.respawnTicks == 0) return;
+    for (int i = 0; i < snakeCount; ++i) {
+        if (!alive[i] && tick >= respawnAt[i]) spawn(i);
+    }
+}
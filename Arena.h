@@ -0,0 +1,116 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "Board.h"
+#include "FreeCellIndex.h"
+#include "Random.h"
+#include "Snake.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 竞技场模式配置
+struct ArenaConfig {
+    BoardSize board = BoardSize(64, 64);
+    int snakeCount = 16;       // 蛇的总数
+    int humanCount = 1;        // 编号最小的若干条蛇由玩家控制，其余由 AI 控制
+    int foodCount = 32;        // 场上同时存在的食物数
+    int initialLength = 3;     // 出生（及复活）后的目标长度
+    int growth = 1;            // 每吃一个食物增长的节数
+    int respawnTicks = 20;     // 死亡后隔多少帧复活，0 表示不复活
+    std::uint64_t seed = 1;
+};
+
+// 多蛇竞技场：N 条蛇共享一张占用网格。
+// 每条蛇的状态按字段分别存放在数组中（SoA），蛇身不单独存储：
+// 网格中每个被占格子记录所属的蛇和"朝蛇头方向的下一格"，蛇尾沿该链前进，移动一步是 O(1)。
+// 每帧依次执行：转向 -> 计算新蛇头 -> 碰撞判定 -> 移动/进食 -> 补充食物 -> 复活，
+// 前三个阶段只读共享网格、只写本蛇的字段，可以按蛇分块并行；碰撞判定只看新蛇头所在的一格，
+// 每帧代价是 O(蛇数)，与蛇身总长无关。
+class Arena {
+public:
+    static constexpr std::int32_t EMPTY = -1;  // 网格中无蛇占用
+    static constexpr int MAX_SNAKES = 4096;
+
+    explicit Arena(const ArenaConfig& config);
+
+    void update();                                     // 推进一个逻辑帧
+    void setDirection(int snake, Direction direction);  // 玩家输入，下一帧生效；与当前方向相反时忽略
+    // 把一条蛇摆到指定位置（从头到尾，格子须互不相同、依次相邻且不被其他蛇占据），用于构造确定的局面；
+    // 原有的蛇身被移除，食物被覆盖时一并移除
+    bool placeSnake(int snake, const std::vector<std::pair<int, int>>& body, Direction direction);
+    void removeSnake(int snake);  // 把一条蛇移出场地，不计死亡；配置了复活时之后照常复活
+    bool placeFood(int x, int y);  // 在空闲格子上放一个食物，用于构造确定的局面
+
+    const ArenaConfig& getConfig() const { return config; }
+    std::uint64_t getTickCount() const { return tick; }
+    int getSnakeCount() const { return snakeCount; }
+    int getAliveCount() const { return aliveCount; }
+    bool isHuman(int snake) const { return snake < config.humanCount; }
+    bool isAlive(int snake) const { return alive[snake] != 0; }
+    std::pair<int, int> getHead(int snake) const { return cellPosition(heads[snake]); }
+    int getLength(int snake) const { return lengths[snake]; }
+    int getScore(int snake) const { return scores[snake]; }
+    int getDeaths(int snake) const { return deaths[snake]; }
+    Direction getDirection(int snake) const { return static_cast<Direction>(directions[snake]); }
+    int occupantAt(int x, int y) const { return occupant[config.board.index(x, y)]; }  // 所属的蛇，或 EMPTY
+    bool hasFood(int x, int y) const { return food[config.board.index(x, y)] != 0; }
+    std::size_t getFoodCount() const { return foodCells.size(); }
+    std::pair<int, int> getFood(std::size_t i) const { return cellPosition(foodCells.at(i)); }
+
+    // 从蛇尾到蛇头依次访问一条蛇的各节
+    template <typename Visit>
+    void forEachSegment(int snake, Visit visit) const {
+        if (!alive[snake]) return;
+        for (std::int32_t cell = tails[snake];; cell = towardHead[cell]) {
+            visit(cellPosition(cell));
+            if (cell == heads[snake]) break;
+        }
+    }
+
+private:
+    ArenaConfig config;
+    int width;
+    int snakeCount;
+    int aliveCount;
+    std::uint64_t tick;
+    Random rng;
+
+    // 每条蛇一项
+    std::vector<std::int32_t> heads;
+    std::vector<std::int32_t> tails;
+    std::vector<std::int32_t> lengths;
+    std::vector<std::int32_t> pendingGrowth;  // 尚未长出的节数，大于 0 时蛇尾不动
+    std::vector<std::int32_t> scores;
+    std::vector<std::int32_t> deaths;
+    std::vector<std::int32_t> targets;        // AI 追逐的食物格子
+    std::vector<std::int32_t> nextHeads;      // 本帧的新蛇头，撞墙时为 EMPTY
+    std::vector<std::uint8_t> directions;
+    std::vector<std::uint8_t> inputs;         // 玩家最近一次输入
+    std::vector<std::uint8_t> alive;
+    std::vector<std::uint8_t> killed;         // 本帧判定死亡
+    std::vector<std::uint64_t> respawnAt;
+
+    // 每个格子一项
+    std::vector<std::int32_t> occupant;
+    std::vector<std::int32_t> towardHead;     // 蛇身中朝蛇头方向的下一格
+    std::vector<std::int32_t> claims;         // 本帧要进入该格的蛇，用于判定头对头相撞，用完即还原
+    std::vector<std::uint8_t> food;
+    FreeCellIndex freeCells;                  // 既无蛇也无食物的格子
+    FreeCellIndex foodCells;                  // 有食物的格子
+
+    std::pair<int, int> cellPosition(std::int32_t cell) const { return {cell % width, cell / width}; }
+    std::int32_t neighbor(std::int32_t cell, Direction direction) const;  // 越界时返回 EMPTY
+    bool isBlocked(std::int32_t cell) const;                             // 本帧进入该格是否会撞上蛇身
+    bool spawn(int snake);
+
+    void steer();
+    void advanceHeads();
+    void resolveCollisions();
+    void applyMoves();
+    void spawnFood();
+    void respawn();
+};
+
+#endif // ARENA_H
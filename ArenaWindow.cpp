@@ -0,0 +1,125 @@
+#include "ArenaWindow.h"
+#include "game.h"
+#include <QKeyEvent>
+#include <QPainter>
+#include <QStringList>
+#include <algorithm>
+
+ArenaWindow::ArenaWindow(const ArenaConfig& config, QWidget *parent)
+    : QWidget(parent)
+    , arena(config)
+    , tickTimer(new QTimer(this))
+    , paused(false)
+{
+    setWindowTitle("Snake Arena");
+    setFocusPolicy(Qt::StrongFocus);
+    const BoardSize &board = arena.getConfig().board;
+    int longestSide = std::max(board.width, board.height);
+    cellSize = std::max(1, std::min(MAX_CELL_SIZE, MAX_BOARD_PIXELS / longestSide));
+    setFixedSize(board.width * cellSize + PANEL_WIDTH, std::max(board.height * cellSize, PANEL_HEIGHT));
+
+    // 逻辑帧间隔与单人对局相同
+    connect(tickTimer, &QTimer::timeout, this, &ArenaWindow::updateArena);
+    tickTimer->start(Game::TICK_INTERVAL_MS);
+}
+
+void ArenaWindow::keyPressEvent(QKeyEvent *event)
+{
+    // 方向键控制 0 号蛇，WASD 控制 1 号蛇；不是玩家控制的蛇忽略输入
+    int snake = -1;
+    Direction direction = Direction::UP;
+    switch (event->key()) {
+        case Qt::Key_Up:    snake = 0; direction = Direction::UP;    break;
+        case Qt::Key_Down:  snake = 0; direction = Direction::DOWN;  break;
+        case Qt::Key_Left:  snake = 0; direction = Direction::LEFT;  break;
+        case Qt::Key_Right: snake = 0; direction = Direction::RIGHT; break;
+        case Qt::Key_W:     snake = 1; direction = Direction::UP;    break;
+        case Qt::Key_S:     snake = 1; direction = Direction::DOWN;  break;
+        case Qt::Key_A:     snake = 1; direction = Direction::LEFT;  break;
+        case Qt::Key_D:     snake = 1; direction = Direction::RIGHT; break;
+        case Qt::Key_P:
+            paused = !paused;
+            update();
+            break;
+    }
+    if (!paused && snake >= 0 && snake < arena.getSnakeCount() && arena.isHuman(snake)) {
+        arena.setDirection(snake, direction);
+    }
+    QWidget::keyPressEvent(event);
+}
+
+void ArenaWindow::updateArena()
+{
+    if (paused) return;
+    arena.update();
+    update();
+}
+
+void ArenaWindow::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    drawBoard(painter);
+    drawScore(painter);
+}
+
+QColor ArenaWindow::snakeColor(int snake) const
+{
+    return QColor::fromHsv(snake * 360 / std::max(1, arena.getSnakeCount()), 200, 220);
+}
+
+void ArenaWindow::drawBoard(QPainter &painter)
+{
+    const BoardSize &board = arena.getConfig().board;
+    for (int y = 0; y < board.height; ++y) {
+        for (int x = 0; x < board.width; ++x) {
+            int snake = arena.occupantAt(x, y);
+            if (snake != Arena::EMPTY) {
+                painter.fillRect(x * cellSize, y * cellSize, cellSize, cellSize, snakeColor(snake).darker(130));
+            } else if (arena.hasFood(x, y)) {
+                painter.fillRect(x * cellSize, y * cellSize, cellSize, cellSize, Qt::red);
+            }
+        }
+    }
+
+    // 蛇头用亮色，玩家控制的蛇头加白框
+    for (int snake = 0; snake < arena.getSnakeCount(); ++snake) {
+        if (!arena.isAlive(snake)) continue;
+        std::pair<int, int> head = arena.getHead(snake);
+        QRect cell(head.first * cellSize, head.second * cellSize, cellSize, cellSize);
+        painter.fillRect(cell, snakeColor(snake).lighter(130));
+        if (arena.isHuman(snake)) {
+            painter.setPen(Qt::white);
+            painter.drawRect(cell.adjusted(0, 0, -1, -1));
+        }
+    }
+
+    painter.setPen(QPen(Qt::white, 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(0, 0, board.width * cellSize, board.height * cellSize);
+}
+
+void ArenaWindow::drawScore(QPainter &painter)
+{
+    QStringList lines;
+    lines << QString("Alive: %1/%2").arg(arena.getAliveCount()).arg(arena.getSnakeCount());
+    for (int snake = 0; snake < arena.getSnakeCount() && arena.isHuman(snake); ++snake) {
+        lines << QString("P%1: %2 (deaths %3)").arg(snake + 1).arg(arena.getScore(snake)).arg(arena.getDeaths(snake));
+    }
+    // AI 只显示最高分
+    int bestAi = 0;
+    for (int snake = 0; snake < arena.getSnakeCount(); ++snake) {
+        if (!arena.isHuman(snake)) bestAi = std::max(bestAi, arena.getScore(snake));
+    }
+    lines << QString("Best AI: %1").arg(bestAi);
+    lines << (paused ? QString("PAUSED") : QString());
+
+    painter.setPen(Qt::white);
+    painter.setFont(QFont("Arial", 12));
+    int left = arena.getConfig().board.width * cellSize + 10;
+    for (int i = 0; i < lines.size(); ++i) {
+        if (!lines[i].isEmpty()) {
+            painter.drawText(left, 30 + 30 * i, lines[i]);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef ARENAWINDOW_H
+#define ARENAWINDOW_H
+
+#include <QTimer>
+#include <QWidget>
+#include "Arena.h"
+
+// 竞技场模式窗口：多条蛇共享一张棋盘，前一两条由键盘控制，其余由 AI 控制。
+// 竞技场在界面线程上按逻辑帧推进，每帧整体重绘棋盘。
+class ArenaWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ArenaWindow(const ArenaConfig& config, QWidget *parent = nullptr);
+
+protected:
+    void keyPressEvent(QKeyEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void updateArena();
+
+private:
+    Arena arena;
+    QTimer *tickTimer;  // 逻辑帧定时器
+    int cellSize;       // 每个格子的像素大小，随棋盘尺寸缩放
+    bool paused;
+    static constexpr int MAX_CELL_SIZE = 20;     // 格子的最大像素大小
+    static constexpr int MAX_BOARD_PIXELS = 800; // 游戏区域的最大像素边长
+    static constexpr int PANEL_WIDTH = 200;      // 右侧信息栏宽度
+    static constexpr int PANEL_HEIGHT = 250;     // 信息栏所需的最小高度
+
+    QColor snakeColor(int snake) const;  // 按编号在色环上均匀取色
+    void drawBoard(QPainter &painter);
+    void drawScore(QPainter &painter);
+};
+
+#endif // ARENAWINDOW_H
@@ -0,0 +1,97 @@
+#include "AsyncPlanner.h"
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+AsyncPlanner::AsyncPlanner(int width, int height)
+    : width(width), height(height), stopping(false), hasPending(false), pendingSerial(0),
+      hasReady(false), latestSerial(0), pathFinder(width, height),
+      releaseTicks(static_cast<std::size_t>(width) * height, 0),
+      obstacleGrid(static_cast<std::size_t>(width) * height, 0), gridHash(0) {
+    worker = std::thread(&AsyncPlanner::run, this);
+}
+
+AsyncPlanner::~AsyncPlanner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    latestSerial.fetch_add(1);
+    wakeCondition.notify_one();
+    worker.join();
+}
+
+void AsyncPlanner::request(PlanRequest& planRequest) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(pending, planRequest);
+        hasPending = true;
+        hasReady = false;
+        pendingSerial = latestSerial.fetch_add(1) + 1;
+    }
+    wakeCondition.notify_one();
+}
+
+bool AsyncPlanner::take(std::uint64_t stateHash, PlanResult& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasReady || ready.stateHash != stateHash) return false;
+    std::swap(result, ready);
+    hasReady = false;
+    return true;
+}
+
+void AsyncPlanner::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hasPending = false;
+    hasReady = false;
+    latestSerial.fetch_add(1);
+}
+
+void AsyncPlanner::rebuildObstacleGrid(const PlanRequest& job) {
+    std::fill(obstacleGrid.begin(), obstacleGrid.end(), 0);
+    for (const auto& obstacle : job.obstacles) {
+        if (obstacle.first >= 0 && obstacle.first < width && obstacle.second >= 0 && obstacle.second < height) {
+            obstacleGrid[static_cast<std::size_t>(obstacle.second) * width + obstacle.first] = 1;
+        }
+    }
+    gridHash = job.obstacleHash;
+}
+
+void AsyncPlanner::run() {
+    PlanRequest job;
+    PlanResult result;
+    for (;;) {
+        std::uint64_t serial;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this] { return stopping || hasPending; });
+            if (stopping) return;
+            std::swap(job, pending);
+            hasPending = false;
+            serial = pendingSerial;
+        }
+
+        std::uint64_t start = steadyClockNs();
+        if (job.obstacleHash != gridHash) {
+            rebuildObstacleGrid(job);
+        }
+
+        // 与同步规划相同的时间感知 BFS，结果逐步一致
+        PathFinder::labelReleaseTicks(job.body, width, height, releaseTicks);
+        result.found = pathFinder.findPath(job.body.front(), job.goal,
+            [this](int x, int y, int step) {
+                std::size_t cell = static_cast<std::size_t>(y) * width + x;
+                return !obstacleGrid[cell] && step >= releaseTicks[cell];
+            }, result.path,
+            [this, serial] { return latestSerial.load(std::memory_order_relaxed) != serial; });
+        PathFinder::clearReleaseTicks(job.body, width, height, releaseTicks);
+        result.stateHash = job.stateHash;
+        result.elapsedNs = steadyClockNs() - start;
+
+        // 搜索期间被新请求取代或被取消时丢弃结果
+        std::lock_guard<std::mutex> lock(mutex);
+        if (latestSerial.load() == serial) {
+            std::swap(ready, result);
+            hasReady = true;
+        }
+    }
+}
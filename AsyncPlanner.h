@@ -0,0 +1,70 @@
+#ifndef ASYNCPLANNER_H
+#define ASYNCPLANNER_H
+
+#include "PathFinder.h"
+#include "Snake.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 一次规划请求：某个局面下从蛇头到食物的时间感知寻路
+struct PlanRequest {
+    std::uint64_t stateHash = 0;                 // 局面的 Zobrist 哈希，取结果时用来核对
+    std::pair<int, int> goal;
+    std::vector<std::pair<int, int>> body;       // 从头到尾
+    std::vector<std::pair<int, int>> obstacles;
+    std::uint64_t obstacleHash = 0;              // 障碍物不变时工作线程复用已建好的网格
+};
+
+// 规划结果
+struct PlanResult {
+    std::uint64_t stateHash = 0;
+    bool found = false;
+    std::vector<Direction> path;  // 不含起点
+    std::uint64_t elapsedNs = 0;  // 搜索耗时
+};
+
+// 自动寻路的后台规划器
+// 逻辑帧结束时为下一帧的局面提交请求，工作线程在两帧之间完成搜索；
+// 新请求会取代并取消尚未完成的旧请求，下一帧只取与当前局面哈希一致的结果。
+class AsyncPlanner {
+public:
+    AsyncPlanner(int width, int height);
+    ~AsyncPlanner();
+    AsyncPlanner(const AsyncPlanner&) = delete;
+    AsyncPlanner& operator=(const AsyncPlanner&) = delete;
+
+    void request(PlanRequest& planRequest);                 // 提交请求（内容被交换走，调用方可复用其容量）
+    bool take(std::uint64_t stateHash, PlanResult& result);  // 取出该局面的已完成结果，没有时返回 false
+    void cancel();                                          // 取消正在进行和尚未开始的请求
+
+private:
+    int width;
+    int height;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    bool stopping;
+    bool hasPending;
+    PlanRequest pending;
+    std::uint64_t pendingSerial;
+    bool hasReady;
+    PlanResult ready;
+    std::atomic<std::uint64_t> latestSerial;  // 每次提交或取消递增，工作线程据此判断当前搜索是否过期
+
+    // 以下只由工作线程访问
+    PathFinder pathFinder;
+    std::vector<int> releaseTicks;
+    std::vector<std::uint8_t> obstacleGrid;
+    std::uint64_t gridHash;
+    std::thread worker;
+
+    void run();
+    void rebuildObstacleGrid(const PlanRequest& job);
+};
+
+#endif // ASYNCPLANNER_H
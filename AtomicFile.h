@@ -0,0 +1,15 @@
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <cstddef>
+#include <string>
+
+// 原子替换文件：先完整写入同目录下的临时文件并刷到磁盘，再改名覆盖目标文件。
+// 中途崩溃或断电时目标文件要么是旧内容，要么是新内容，不会出现写了一半的文件。
+namespace AtomicFile {
+
+bool write(const std::string& filename, const void* data, std::size_t size);
+
+} // namespace AtomicFile
+
+#endif // ATOMICFILE_H
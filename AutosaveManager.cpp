@@ -0,0 +1,117 @@
+#include "AutosaveManager.h"
+#include "AtomicFile.h"
+#include "SaveFile.h"
+#include <algorithm>
+#include <map>
+#include <utility>
+
+AutosaveManager::AutosaveManager(const std::string& directory, int slotCount)
+    : directory(directory), slotCount(std::max(1, slotCount)), stopping(false), hasPending(false),
+      restartPending(false), savedCount(0), hasBase(false), nextSequence(1), chainLength(0) {
+    // 序号接着磁盘上已有的存档编号，新旧存档混在槽位里时仍能按序号找出最新的一条链
+    for (int slot = 0; slot < this->slotCount; ++slot) {
+        SaveFile::AutosaveImage image;
+        if (SaveFile::readAutosave(slotPath(slot), image)) {
+            nextSequence = std::max(nextSequence, image.sequence + 1);
+        }
+    }
+    worker = std::thread(&AutosaveManager::run, this);
+}
+
+AutosaveManager::~AutosaveManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+    worker.join();
+}
+
+std::string AutosaveManager::slotPath(int slot) const {
+    return directory + "/autosave-" + std::to_string(slot) + ".snake";
+}
+
+void AutosaveManager::submit(GameState& state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(pending, state);
+        hasPending = true;
+    }
+    wakeCondition.notify_one();
+}
+
+void AutosaveManager::restart() {
+    std::lock_guard<std::mutex> lock(mutex);
+    restartPending = true;
+}
+
+std::uint64_t AutosaveManager::getSavedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return savedCount;
+}
+
+void AutosaveManager::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeCondition.wait(lock, [&] { return stopping || hasPending; });
+        if (!hasPending) break;
+        std::swap(current, pending);
+        hasPending = false;
+        if (restartPending) {
+            hasBase = false;
+            restartPending = false;
+        }
+        lock.unlock();
+
+        // 链已占满所有槽位或没有可用的基准时写完整存档，否则写增量
+        bool full = !hasBase || chainLength >= static_cast<std::uint64_t>(slotCount) ||
+                    current.width != base.width || current.height != base.height;
+        std::uint64_t sequence = nextSequence++;
+        SaveFile::encodeAutosave(sequence, full ? nullptr : &base, current, buffer);
+        int slot = static_cast<int>(sequence % static_cast<std::uint64_t>(slotCount));
+        bool written = AtomicFile::write(slotPath(slot), buffer.data(), buffer.size());
+        if (written) {
+            std::swap(base, current);
+            hasBase = true;
+            chainLength = full ? 1 : chainLength + 1;
+        } else {
+            // 槽位里留着旧内容，后续增量接不上，下次改写完整存档
+            hasBase = false;
+        }
+
+        lock.lock();
+        if (written) ++savedCount;
+    }
+}
+
+bool AutosaveManager::loadLatest(GameState& state) const {
+    std::map<std::uint64_t, SaveFile::AutosaveImage> images;
+    for (int slot = 0; slot < slotCount; ++slot) {
+        SaveFile::AutosaveImage image;
+        if (SaveFile::readAutosave(slotPath(slot), image)) {
+            images[image.sequence] = std::move(image);
+        }
+    }
+
+    // 从最新的存档往回找到完整存档，再顺着序号逐个应用增量；链断开时退到更早的存档
+    for (auto latest = images.rbegin(); latest != images.rend(); ++latest) {
+        std::uint64_t first = latest->first;
+        while (images[first].delta && images.count(first - 1) != 0) {
+            --first;
+        }
+        if (images[first].delta) continue;
+
+        GameState restored;
+        bool ok = SaveFile::decodeAutosave(images[first], nullptr, restored);
+        for (std::uint64_t sequence = first + 1; ok && sequence <= latest->first; ++sequence) {
+            GameState next;
+            ok = SaveFile::decodeAutosave(images[sequence], &restored, next);
+            restored = std::move(next);
+        }
+        if (ok) {
+            state = std::move(restored);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef AUTOSAVEMANAGER_H
+#define AUTOSAVEMANAGER_H
+
+#include "GameState.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 轮换槽位的自动存档
+// 模拟线程只把局面交给 submit（交换缓冲区，不分配、不做文件读写），
+// 后台线程编码并原子写入下一个槽位（写入后刷盘）。每轮第一个存档是完整存档，
+// 之后的存档只记录相对前一个存档的增量，一条增量链不超过槽位数，崩溃后总能从磁盘上恢复最新的局面。
+class AutosaveManager {
+public:
+    AutosaveManager(const std::string& directory, int slotCount);  // 目录须已存在；从已有存档的最大序号之后继续编号
+    ~AutosaveManager();  // 写完尚未写出的存档后退出
+    AutosaveManager(const AutosaveManager&) = delete;
+    AutosaveManager& operator=(const AutosaveManager&) = delete;
+
+    void submit(GameState& state);  // 提交局面（内容被交换走，调用方可复用其容量）；尚未写出的旧局面被取代
+    void restart();                 // 换了新对局，下一个存档从完整存档开始
+    bool loadLatest(GameState& state) const;  // 读出磁盘上最新的可恢复局面，没有时返回 false
+    std::uint64_t getSavedCount() const;      // 已写出的存档数
+
+private:
+    std::string directory;
+    int slotCount;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeCondition;
+    bool stopping;
+    bool hasPending;
+    bool restartPending;          // 下一个存档须为完整存档
+    GameState pending;
+    std::uint64_t savedCount;
+
+    // 以下只由写线程访问
+    GameState current;
+    GameState base;               // 上一个成功写出的局面，增量相对它编码
+    bool hasBase;
+    std::uint64_t nextSequence;
+    std::uint64_t chainLength;    // 当前增量链已占用的槽位数（含完整存档）
+    std::vector<char> buffer;
+    std::thread worker;
+
+    std::string slotPath(int slot) const;
+    void run();
+};
+
+#endif // AUTOSAVEMANAGER_H
@@ -0,0 +1,175 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// 由基础种子和对局编号派生出互不相关的非零种子
+static std::uint64_t mixSeed(std::uint64_t value) {
+    std::uint64_t mixed = Random::splitMix64(value);
+    return mixed == 0 ? 1 : mixed;
+}
+
+void BatchStats::record(const Game& game, Ending ending) {
+    ++games;
+    ticks += game.getTickCount();
+    totalLength += game.getSnake().getBody().size();
+    totalScore += game.getScore();
+    ++endings[ending];
+
+    std::size_t bucket = static_cast<std::size_t>(game.getScore() / 10);
+    if (bucket >= scoreHistogram.size()) {
+        scoreHistogram.resize(bucket + 1, 0);
+    }
+    ++scoreHistogram[bucket];
+    planLatency.merge(game.getPlanLatency());
+}
+
+void BatchStats::merge(const BatchStats& other) {
+    games += other.games;
+    ticks += other.ticks;
+    totalLength += other.totalLength;
+    totalScore += other.totalScore;
+    for (int i = 0; i < ENDING_COUNT; ++i) {
+        endings[i] += other.endings[i];
+    }
+    if (other.scoreHistogram.size() > scoreHistogram.size()) {
+        scoreHistogram.resize(other.scoreHistogram.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.scoreHistogram.size(); ++i) {
+        scoreHistogram[i] += other.scoreHistogram[i];
+    }
+    planLatency.merge(other.planLatency);
+    incompleteCycles += other.incompleteCycles;
+    uncoveredCells += other.uncoveredCells;
+}
+
+BatchRunner::BatchRunner(const BatchOptions& options) : options(options), elapsedSeconds(0.0) {
+    if (this->options.threads <= 0) {
+        this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->options.chunkSize = std::max(1, this->options.chunkSize);
+    // 批量对局自动寻路常开
+    this->options.game.alwaysAutoPath = true;
+}
+
+BatchStats BatchRunner::run() {
+    int threadCount = options.threads;
+    queues = std::vector<WorkerQueue>(static_cast<std::size_t>(threadCount));
+    reports.assign(static_cast<std::size_t>(threadCount), WorkerReport());
+
+    // 连续的任务块依次分给各线程，负载不均时靠窃取平衡
+    long long taskCount = (options.games + options.chunkSize - 1) / options.chunkSize;
+    for (long long t = 0; t < taskCount; ++t) {
+        Task task = {t * options.chunkSize, std::min(options.games, (t + 1) * options.chunkSize)};
+        std::size_t owner = static_cast<std::size_t>(t * threadCount / taskCount);
+        queues[owner].tasks.push_back(task);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&BatchRunner::workerLoop, this, i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BatchStats total;
+    for (const auto& report : reports) {
+        total.merge(report.stats);
+    }
+    return total;
+}
+
+void BatchRunner::workerLoop(int worker) {
+    auto start = std::chrono::steady_clock::now();
+    WorkerReport report;  // 线程内局部统计，结束时再写回，避免伪共享
+    std::uint64_t victimSeed = mixSeed(options.seed ^ static_cast<std::uint64_t>(worker));
+
+    Task task;
+    for (;;) {
+        if (!popLocal(worker, task)) {
+            if (!steal(worker, victimSeed, task)) {
+                break;  // 所有队列都空了，且不会再有新任务
+            }
+            ++report.steals;
+        }
+        for (long long i = task.begin; i < task.end; ++i) {
+            playGame(i, report.stats);
+        }
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    reports[static_cast<std::size_t>(worker)] = report;
+}
+
+bool BatchRunner::popLocal(int worker, Task& task) {
+    WorkerQueue& queue = queues[static_cast<std::size_t>(worker)];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool BatchRunner::steal(int thief, std::uint64_t& victimSeed, Task& task) {
+    int threadCount = static_cast<int>(queues.size());
+    // 从随机位置开始依次尝试每个线程
+    victimSeed = mixSeed(victimSeed);
+    int first = static_cast<int>(victimSeed % static_cast<std::uint64_t>(threadCount));
+    for (int k = 0; k < threadCount; ++k) {
+        int victim = (first + k) % threadCount;
+        if (victim == thief) continue;
+
+        WorkerQueue& queue = queues[static_cast<std::size_t>(victim)];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void BatchRunner::playGame(long long index, BatchStats& stats) const {
+    GameConfig config = options.game;
+    config.seed = mixSeed(options.seed + static_cast<std::uint64_t>(index));
+    Game game(config);
+
+    // 长时间吃不到食物视为原地兜圈，提前结束
+    const std::uint64_t stallLimit = static_cast<std::uint64_t>(game.getBoardSize().cellCount()) * 4;
+    std::uint64_t lastScoreTick = 0;
+    int lastScore = game.getScore();
+
+    while (!game.isGameOver() && game.getTickCount() < options.maxTicks) {
+        game.update();
+        if (game.getScore() != lastScore) {
+            lastScore = game.getScore();
+            lastScoreTick = game.getTickCount();
+        } else if (game.getTickCount() - lastScoreTick > stallLimit) {
+            break;
+        }
+    }
+
+    // 回路没有覆盖全部空闲格子时 HAMILTON 策略无法填满棋盘，单独统计
+    if (config.autoPathStrategy == Game::AutoPathStrategy::HAMILTON) {
+        int uncovered = game.getUncoveredCycleCells();
+        if (uncovered > 0) {
+            ++stats.incompleteCycles;
+            stats.uncoveredCells += uncovered;
+        }
+    }
+    if (!game.isGameOver() && game.getTickCount() - lastScoreTick > stallLimit) {
+        stats.record(game, BatchStats::STALLED);
+        return;
+    }
+
+    switch (game.getOutcome()) {
+        case Game::Outcome::WON: stats.record(game, BatchStats::WON); break;
+        case Game::Outcome::HIT_WALL: stats.record(game, BatchStats::HIT_WALL); break;
+        case Game::Outcome::HIT_SELF: stats.record(game, BatchStats::HIT_SELF); break;
+        case Game::Outcome::HIT_OBSTACLE: stats.record(game, BatchStats::HIT_OBSTACLE); break;
+        case Game::Outcome::PLAYING: stats.record(game, BatchStats::TICK_LIMIT); break;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "game.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// 批量模拟参数
+struct BatchOptions {
+    long long games = 10000;         // 对局数
+    int threads = 0;                 // 工作线程数，0 表示使用全部核心
+    int chunkSize = 16;              // 每个任务包含的对局数
+    std::uint64_t seed = 1;          // 基础种子，第 i 局的种子由它派生，结果与调度无关
+    std::uint64_t maxTicks = 200000; // 单局帧数上限
+    GameConfig game;                 // 棋盘尺寸、难度等对局配置
+};
+
+// 批量模拟统计
+struct BatchStats {
+    // 对局结束原因
+    enum Ending {
+        WON,
+        HIT_WALL,
+        HIT_SELF,
+        HIT_OBSTACLE,
+        STALLED,       // 长时间没有吃到食物（自动寻路原地兜圈）
+        TICK_LIMIT,    // 达到单局帧数上限
+        ENDING_COUNT
+    };
+
+    long long games = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t totalLength = 0;          // 结束时蛇身长度之和
+    long long totalScore = 0;
+    long long endings[ENDING_COUNT] = {};
+    std::vector<long long> scoreHistogram;  // 下标为吃到的食物数（得分 / 10）
+    long long incompleteCycles = 0;         // HAMILTON 回路没有覆盖全部空闲格子的对局数
+    long long uncoveredCells = 0;           // 这些对局中回路没有覆盖的格子数之和
+    LatencyHistogram planLatency;           // 自动寻路单次搜索耗时
+
+    void record(const Game& game, Ending ending);
+    void merge(const BatchStats& other);
+};
+
+// 单个工作线程的运行情况
+struct WorkerReport {
+    BatchStats stats;
+    double seconds = 0.0;  // 线程运行时间
+    long long steals = 0;  // 从其他线程窃取的任务数
+};
+
+// 多线程批量模拟器
+// 对局被切成若干任务分配到各线程的双端队列；线程从自己队列的尾部取任务，
+// 队列空了就随机挑选其他线程从头部窃取，直到所有队列都为空。
+class BatchRunner {
+public:
+    explicit BatchRunner(const BatchOptions& options);
+
+    BatchStats run();  // 阻塞直到全部对局结束，返回汇总统计
+    const std::vector<WorkerReport>& getWorkerReports() const { return reports; }
+    double getElapsedSeconds() const { return elapsedSeconds; }
+
+private:
+    struct Task {
+        long long begin;  // 对局编号区间 [begin, end)
+        long long end;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    BatchOptions options;
+    std::vector<WorkerQueue> queues;
+    std::vector<WorkerReport> reports;
+    double elapsedSeconds;
+
+    void workerLoop(int worker);
+    bool popLocal(int worker, Task& task);
+    bool steal(int thief, std::uint64_t& victimSeed, Task& task);
+    void playGame(long long index, BatchStats& stats) const;
+};
+
+#endif // BATCHRUNNER_H
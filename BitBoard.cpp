@@ -0,0 +1,144 @@
+#include "BitBoard.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITBOARD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITBOARD_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace {
+
+int popcount64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 每行一个字时的扩展：next[i] = cur[i] | ((左右移一位 | 上下两行) & pass[i])，返回是否有变化。
+// 行尾补零位在 pass 中为 0，左右移出界的位会被屏蔽；哨兵行保证 i ± 1 总是有效下标。
+bool expandNarrow(const std::uint64_t* cur, std::uint64_t* next, const std::uint64_t* pass, int rows) {
+    int i = 1;
+    std::uint64_t changed = 0;
+#if defined(BITBOARD_AVX2)
+    __m256i changedVec = _mm256_setzero_si256();
+    for (; i + 4 <= rows + 1; i += 4) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + i));
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + i - 1));
+        __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + i + 1));
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pass + i));
+        __m256i grown = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(c, 1)),
+                                        _mm256_or_si256(up, down));
+        grown = _mm256_or_si256(c, _mm256_and_si256(grown, p));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + i), grown);
+        changedVec = _mm256_or_si256(changedVec, _mm256_xor_si256(grown, c));
+    }
+    changed = _mm256_testz_si256(changedVec, changedVec) ? 0 : 1;
+#elif defined(BITBOARD_SSE2)
+    __m128i changedVec = _mm_setzero_si128();
+    for (; i + 2 <= rows + 1; i += 2) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i));
+        __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i - 1));
+        __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i + 1));
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pass + i));
+        __m128i grown = _mm_or_si128(_mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(c, 1)),
+                                     _mm_or_si128(up, down));
+        grown = _mm_or_si128(c, _mm_and_si128(grown, p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(next + i), grown);
+        changedVec = _mm_or_si128(changedVec, _mm_xor_si128(grown, c));
+    }
+    changed = _mm_movemask_epi8(_mm_cmpeq_epi8(changedVec, _mm_setzero_si128())) == 0xFFFF ? 0 : 1;
+#endif
+    for (; i <= rows; ++i) {
+        std::uint64_t c = cur[i];
+        std::uint64_t grown = c | (((c << 1) | (c >> 1) | cur[i - 1] | cur[i + 1]) & pass[i]);
+        next[i] = grown;
+        changed |= grown ^ c;
+    }
+    return changed != 0;
+}
+
+// 一般宽度：左右移动要在同一行的相邻字之间进位
+bool expandWide(const std::uint64_t* cur, std::uint64_t* next, const std::uint64_t* pass, int rows, int stride) {
+    std::uint64_t changed = 0;
+    for (int row = 1; row <= rows; ++row) {
+        std::size_t base = static_cast<std::size_t>(row) * stride;
+        for (int w = 0; w < stride; ++w) {
+            std::size_t i = base + w;
+            std::uint64_t c = cur[i];
+            std::uint64_t left = c >> 1;
+            std::uint64_t right = c << 1;
+            if (w + 1 < stride) left |= cur[i + 1] << 63;
+            if (w > 0) right |= cur[i - 1] >> 63;
+            std::uint64_t grown = c | ((left | right | cur[i - stride] | cur[i + stride]) & pass[i]);
+            next[i] = grown;
+            changed |= grown ^ c;
+        }
+    }
+    return changed != 0;
+}
+
+} // namespace
+
+BitBoard::BitBoard(int width, int height)
+    : width(width), height(height), stride((width + 63) / 64),
+      words(static_cast<std::size_t>(height + 2) * stride, 0),
+      rowMask(static_cast<std::size_t>(stride), ~std::uint64_t(0)),
+      next(words.size(), 0) {
+    if (width % 64 != 0) {
+        rowMask.back() = (std::uint64_t(1) << (width % 64)) - 1;
+    }
+}
+
+void BitBoard::clear() {
+    std::fill(words.begin(), words.end(), 0);
+}
+
+int BitBoard::count() const {
+    int total = 0;
+    for (std::uint64_t word : words) {
+        total += popcount64(word);
+    }
+    return total;
+}
+
+void BitBoard::assignFree(const BitBoard& a, const BitBoard& b) {
+    std::size_t first = static_cast<std::size_t>(stride);
+    std::size_t last = static_cast<std::size_t>(height + 1) * stride;
+    for (std::size_t i = first; i < last; ++i) {
+        words[i] = ~(a.words[i] | b.words[i]) & rowMask[i % stride];
+    }
+}
+
+bool BitBoard::expand(const BitBoard& passable) {
+    bool changed = stride == 1 ? expandNarrow(words.data(), next.data(), passable.words.data(), height)
+                               : expandWide(words.data(), next.data(), passable.words.data(), height, stride);
+    words.swap(next);
+    return changed;
+}
+
+int BitBoard::fill(const BitBoard& passable) {
+    while (expand(passable)) {
+    }
+    return count();
+}
+
+bool BitBoard::fillUntil(const BitBoard& passable, int x, int y) {
+    while (!test(x, y)) {
+        if (!expand(passable)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 按位存储的格子集合
+// 每行占 stride 个 64 位字（行尾补零），上下各多一行全零的哨兵行，
+// 上下移动只是相邻行的字、左右移动是字内移位，洪水填充整行整行地推进。
+// 宽度不超过 64 时每行一个字，扩展内核按编译目标使用 AVX2 / SSE2 一次处理多行，否则逐字处理。
+class BitBoard {
+public:
+    BitBoard(int width, int height);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    void clear();
+    void set(int x, int y) { words[wordIndex(x, y)] |= bit(x); }
+    void reset(int x, int y) { words[wordIndex(x, y)] &= ~bit(x); }
+    bool test(int x, int y) const { return (words[wordIndex(x, y)] & bit(x)) != 0; }
+    int count() const;
+
+    void assignFree(const BitBoard& a, const BitBoard& b);  // 置为棋盘内不属于 a 也不属于 b 的格子
+
+    // 以当前集合为种子，在 passable 内做四连通洪水填充；种子不在 passable 内的部分也会保留
+    int fill(const BitBoard& passable);                     // 填满整个连通区域，返回区域格子数
+    bool fillUntil(const BitBoard& passable, int x, int y);  // 填充到 (x, y) 进入区域为止，返回能否到达
+
+private:
+    int width;
+    int height;
+    int stride;                         // 每行的字数
+    std::vector<std::uint64_t> words;   // (height + 2) * stride 个字，首尾各一行哨兵
+    std::vector<std::uint64_t> rowMask; // 一行中有效位的掩码
+    std::vector<std::uint64_t> next;    // 填充时的双缓冲
+
+    std::size_t wordIndex(int x, int y) const {
+        return static_cast<std::size_t>(y + 1) * stride + static_cast<std::size_t>(x >> 6);
+    }
+    static std::uint64_t bit(int x) { return std::uint64_t(1) << (x & 63); }
+    bool expand(const BitBoard& passable);  // 向四周扩展一格，返回区域是否变化
+};
+
+#endif // BITBOARD_H
@@ -0,0 +1,27 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstddef>
+
+// 运行时棋盘尺寸
+struct BoardSize {
+    static constexpr int MIN_SIZE = 8;       // 最小边长（保证初始蛇身和障碍物区域放得下）
+    static constexpr int MAX_SIZE = 4096;    // 最大边长
+    static constexpr int DEFAULT_SIZE = 20;  // 经典棋盘边长
+
+    int width;
+    int height;
+
+    constexpr BoardSize(int w = DEFAULT_SIZE, int h = DEFAULT_SIZE)
+        : width(clampSide(w)), height(clampSide(h)) {}
+
+    constexpr bool contains(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    constexpr int index(int x, int y) const { return y * width + x; }
+    constexpr std::size_t cellCount() const { return static_cast<std::size_t>(width) * height; }
+
+    static constexpr int clampSide(int side) {
+        return side < MIN_SIZE ? MIN_SIZE : (side > MAX_SIZE ? MAX_SIZE : side);
+    }
+};
+
+#endif // BOARD_H
@@ -1,10 +1,9 @@
 #ifndef FOOD_H
 #define FOOD_H
 
+#include "FreeCellIndex.h"
+#include "Random.h"
 #include <utility>
-#include <list>
-#include <random>
-#include <vector>
 
 class Food {
 public:
@@ -14,8 +13,8 @@ public:
     };
 
     Food();                        // 构造函数
-    void generateNew(int width, int height, const std::list<std::pair<int, int>>& snakeBody,
-                    const std::vector<std::pair<int, int>>& obstacles);  // 生成新的食物
+    bool generateNew(int width, const FreeCellIndex& freeCells, Random& rng);  // 从空闲格子中生成新的食物，没有空闲格子时返回 false
+    void place(std::pair<int, int> pos, Type newType);  // 直接放置食物（读档用）
     std::pair<int, int> getPosition() const;  // 获取食物位置
     Type getType() const;
     bool isSpecial() const;
@@ -23,8 +22,6 @@ public:
 private:
     std::pair<int, int> position;
     Type type;
-    static std::random_device rd;  // 静态随机设备
-    static std::mt19937 gen;       // 静态随机数生成器
 };
 
-#endif // FOOD_H 
\ No newline at end of file
+#endif // FOOD_H 
@@ -0,0 +1,35 @@
+#include "FreeCellIndex.h"
+
+FreeCellIndex::FreeCellIndex(int cellCount) : positions(static_cast<std::size_t>(cellCount), ABSENT) {
+    cells.reserve(static_cast<std::size_t>(cellCount));
+}
+
+void FreeCellIndex::insert(int cell) {
+    if (positions[cell] != ABSENT) return;
+    positions[cell] = static_cast<int>(cells.size());
+    cells.push_back(cell);
+}
+
+void FreeCellIndex::erase(int cell) {
+    int slot = positions[cell];
+    if (slot < 0) return;
+
+    // 用末尾元素填补空位
+    int last = cells.back();
+    cells[slot] = last;
+    positions[last] = slot;
+    cells.pop_back();
+    positions[cell] = ABSENT;
+}
+
+void FreeCellIndex::exclude(int cell) {
+    erase(cell);
+    positions[cell] = EXCLUDED;
+}
+
+void FreeCellIndex::clear() {
+    for (int cell : cells) {
+        positions[cell] = ABSENT;
+    }
+    cells.clear();
+}
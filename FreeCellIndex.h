@@ -0,0 +1,34 @@
+#ifndef FREECELLINDEX_H
+#define FREECELLINDEX_H
+
+#include <cstddef>
+#include <vector>
+
+// 空闲格子索引
+// 空闲格子保存在稠密数组中，另有“格子 -> 数组下标”的反向索引：
+// 插入追加到末尾，删除与末尾元素交换后弹出，两者都是 O(1)；
+// 随机抽取一个空闲格子只需一次随机下标。
+// 被排除的格子（如食物不能出现的边缘）永远不会进入索引。
+class FreeCellIndex {
+public:
+    explicit FreeCellIndex(int cellCount);
+
+    void insert(int cell);            // 标记为空闲（已空闲或被排除时忽略）
+    void erase(int cell);             // 标记为占用（不在索引中时忽略）
+    void exclude(int cell);           // 永久排除该格子
+    void clear();                     // 清空索引，保留排除标记
+    bool contains(int cell) const { return positions[cell] >= 0; }
+    bool isExcluded(int cell) const { return positions[cell] == EXCLUDED; }
+    std::size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    int at(std::size_t i) const { return cells[i]; }  // 第 i 个空闲格子，配合随机下标使用
+
+private:
+    static constexpr int ABSENT = -1;
+    static constexpr int EXCLUDED = -2;
+
+    std::vector<int> cells;  // 空闲格子（无序）
+    std::vector<int> positions;  // 每个格子在 cells 中的下标，或 ABSENT / EXCLUDED
+};
+
+#endif // FREECELLINDEX_H
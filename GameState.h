@@ -0,0 +1,33 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include "Random.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 对局的完整状态，用于存档、读档等需要原样恢复对局的场合
+struct GameState {
+    int width = 0;
+    int height = 0;
+    std::uint8_t difficulty = 0;         // Game::Difficulty
+    std::uint8_t initialDifficulty = 0;  // 开局难度
+    std::uint8_t direction = 0;          // Direction
+    std::uint8_t outcome = 0;            // Game::Outcome
+    std::uint8_t foodType = 0;           // Food::Type
+    bool paused = false;
+    bool autoPathEnabled = false;
+    bool alwaysAutoPath = false;
+    std::int32_t score = 0;
+    std::int32_t highScore = 0;
+    std::uint64_t tickCount = 0;
+    std::uint64_t autoPathStartTick = 0;
+    std::uint64_t seed = 0;
+    Random::State rng = {};
+    std::pair<int, int> food;
+    std::vector<std::pair<int, int>> body;       // 从头到尾
+    std::vector<std::pair<int, int>> obstacles;
+    std::vector<std::uint8_t> path;              // 自动寻路尚未走完的路径（Direction）
+};
+
+#endif // GAMESTATE_H
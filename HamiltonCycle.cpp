@@ -0,0 +1,186 @@
+#include "HamiltonCycle.h"
+#include <algorithm>
+
+namespace {
+
+// 块之间的生成树边，按块记录
+enum : std::uint8_t {
+    LINK_LEFT = 1,
+    LINK_RIGHT = 2,
+    LINK_UP = 4,
+    LINK_DOWN = 8
+};
+
+} // namespace
+
+HamiltonCycle::HamiltonCycle(int width, int height)
+    : width(width), height(height), cycleLength(0), uncoveredCount(0),
+      order(static_cast<std::size_t>(width) * height, -1),
+      next(static_cast<std::size_t>(width) * height, static_cast<std::uint8_t>(Direction::RIGHT)) {
+}
+
+void HamiltonCycle::build(const std::vector<std::uint8_t>& blocked, bool extend) {
+    int blocksX = width / 2;
+    int blocksY = height / 2;
+    int blockCount = blocksX * blocksY;
+    std::fill(order.begin(), order.end(), -1);
+    cycleLength = 0;
+    uncoveredCount = 0;
+    for (std::uint8_t cell : blocked) {
+        uncoveredCount += cell ? 0 : 1;
+    }
+
+    std::vector<std::uint8_t> usable(static_cast<std::size_t>(blockCount), 0);
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            int x = bx * 2;
+            int y = by * 2;
+            usable[by * blocksX + bx] = !blocked[index(x, y)] && !blocked[index(x + 1, y)] &&
+                                        !blocked[index(x, y + 1)] && !blocked[index(x + 1, y + 1)];
+        }
+    }
+
+    // 按连通分量做 BFS，保留最大分量的 BFS 树作为生成树
+    static const int DBX[4] = {-1, 1, 0, 0};
+    static const int DBY[4] = {0, 0, -1, 1};
+    static const std::uint8_t LINKS[4] = {LINK_LEFT, LINK_RIGHT, LINK_UP, LINK_DOWN};
+    static const std::uint8_t BACK_LINKS[4] = {LINK_RIGHT, LINK_LEFT, LINK_DOWN, LINK_UP};
+
+    std::vector<int> component(static_cast<std::size_t>(blockCount), -1);
+    std::vector<int> queue;
+    queue.reserve(static_cast<std::size_t>(blockCount));
+    int bestRoot = -1;
+    std::size_t bestSize = 0;
+    for (int root = 0; root < blockCount; ++root) {
+        if (!usable[root] || component[root] >= 0) continue;
+        queue.clear();
+        queue.push_back(root);
+        component[root] = root;
+        for (std::size_t front = 0; front < queue.size(); ++front) {
+            int block = queue[front];
+            int bx = block % blocksX;
+            int by = block / blocksX;
+            for (int i = 0; i < 4; ++i) {
+                int nx = bx + DBX[i];
+                int ny = by + DBY[i];
+                if (nx < 0 || nx >= blocksX || ny < 0 || ny >= blocksY) continue;
+                int neighbor = ny * blocksX + nx;
+                if (usable[neighbor] && component[neighbor] < 0) {
+                    component[neighbor] = root;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+        if (queue.size() > bestSize) {
+            bestSize = queue.size();
+            bestRoot = root;
+        }
+    }
+    if (bestRoot < 0) return;
+
+    std::vector<std::uint8_t> links(static_cast<std::size_t>(blockCount), 0);
+    std::vector<std::uint8_t> inTree(static_cast<std::size_t>(blockCount), 0);
+    queue.clear();
+    queue.push_back(bestRoot);
+    inTree[bestRoot] = 1;
+    for (std::size_t front = 0; front < queue.size(); ++front) {
+        int block = queue[front];
+        int bx = block % blocksX;
+        int by = block / blocksX;
+        for (int i = 0; i < 4; ++i) {
+            int nx = bx + DBX[i];
+            int ny = by + DBY[i];
+            if (nx < 0 || nx >= blocksX || ny < 0 || ny >= blocksY) continue;
+            int neighbor = ny * blocksX + nx;
+            if (usable[neighbor] && !inTree[neighbor]) {
+                inTree[neighbor] = 1;
+                links[block] |= LINKS[i];
+                links[neighbor] |= BACK_LINKS[i];
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    // 每个块单独是一个逆时针的 4 格小环（左上→左下→右下→右上→左上）；
+    // 沿生成树边把相邻两个小环的一对平行边换成一对交叉边即可合并成一个环：
+    //   向左有边时左上格改为向左，向下有边时左下格改为向下，
+    //   向右有边时右下格改为向右，向上有边时右上格改为向上
+    for (int block : queue) {
+        int x = (block % blocksX) * 2;
+        int y = (block / blocksX) * 2;
+        std::uint8_t link = links[block];
+        next[index(x, y)] = static_cast<std::uint8_t>((link & LINK_LEFT) ? Direction::LEFT : Direction::DOWN);
+        next[index(x, y + 1)] = static_cast<std::uint8_t>((link & LINK_DOWN) ? Direction::DOWN : Direction::RIGHT);
+        next[index(x + 1, y + 1)] = static_cast<std::uint8_t>((link & LINK_RIGHT) ? Direction::RIGHT : Direction::UP);
+        next[index(x + 1, y)] = static_cast<std::uint8_t>((link & LINK_UP) ? Direction::UP : Direction::LEFT);
+    }
+
+    int total = static_cast<int>(queue.size()) * 4;
+    if (extend) {
+        total += spliceFreePairs(blocked, queue, blocksX);
+    }
+
+    // 从根块左上格出发绕行一周，依次编号
+    int x = (bestRoot % blocksX) * 2;
+    int y = (bestRoot / blocksX) * 2;
+    for (int i = 0; i < total; ++i) {
+        order[index(x, y)] = i;
+        switch (static_cast<Direction>(next[index(x, y)])) {
+            case Direction::UP: --y; break;
+            case Direction::DOWN: ++y; break;
+            case Direction::LEFT: --x; break;
+            case Direction::RIGHT: ++x; break;
+            default: break;
+        }
+    }
+    cycleLength = total;
+    uncoveredCount -= total;
+}
+
+int HamiltonCycle::spliceFreePairs(const std::vector<std::uint8_t>& blocked, const std::vector<int>& blocks, int blocksX) {
+    static const int DX[4] = {0, 0, -1, 1};  // 按 Direction 顺序
+    static const int DY[4] = {-1, 1, 0, 0};
+    static const int PERPENDICULAR[4][2] = {{2, 3}, {2, 3}, {0, 1}, {0, 1}};
+
+    std::vector<std::uint8_t> onCycle(order.size(), 0);
+    std::vector<int> work;
+    for (int block : blocks) {
+        int x = (block % blocksX) * 2;
+        int y = (block / blocksX) * 2;
+        for (int cell : {index(x, y), index(x + 1, y), index(x, y + 1), index(x + 1, y + 1)}) {
+            onCycle[cell] = 1;
+            work.push_back(cell);
+        }
+    }
+
+    // 检查回路边 u->v 两侧：a、b 空闲且不在回路上时把它们接进来，新产生的三条边再放回待查列表
+    int added = 0;
+    while (!work.empty()) {
+        int u = work.back();
+        work.pop_back();
+        int d = next[u];
+        int ux = u % width;
+        int uy = u / width;
+        for (int p : PERPENDICULAR[d]) {
+            int ax = ux + DX[p];
+            int ay = uy + DY[p];
+            int bx = ax + DX[d];
+            int by = ay + DY[d];
+            if (ax < 0 || ax >= width || ay < 0 || ay >= height || bx < 0 || bx >= width || by < 0 || by >= height) continue;
+            int a = index(ax, ay);
+            int b = index(bx, by);
+            if (blocked[a] || blocked[b] || onCycle[a] || onCycle[b]) continue;
+            next[u] = static_cast<std::uint8_t>(p);
+            next[a] = static_cast<std::uint8_t>(d);
+            next[b] = static_cast<std::uint8_t>(p ^ 1);  // 相反方向的编号只差最低位
+            onCycle[a] = 1;
+            onCycle[b] = 1;
+            work.push_back(u);
+            work.push_back(a);
+            work.push_back(b);
+            added += 2;
+            break;
+        }
+    }
+    return added;
+}
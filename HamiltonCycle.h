@@ -0,0 +1,46 @@
+#ifndef HAMILTONCYCLE_H
+#define HAMILTONCYCLE_H
+
+#include "Snake.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 覆盖棋盘空闲格子的哈密顿回路
+// 把棋盘划分为 2x2 的块，在不含障碍物的块上求一棵生成树，再沿生成树外沿绕行一周，
+// 得到经过这些块中每个格子恰好一次的回路；不连通时只取最大的连通分量。
+// 扩展时再把回路旁成对的空闲格子并入回路（回路边 u->v 旁边相邻的 a、b 空闲时改为 u->a->b->v），
+// 含障碍物的块、奇数边长时多出的一行（列）大多因此被覆盖。网格上的回路长度总是偶数，
+// 单个障碍物旁通常仍会剩下一个格子不在回路上。
+// 构建后每个格子的回路序号和下一步方向都是 O(1) 查询。
+class HamiltonCycle {
+public:
+    HamiltonCycle(int width, int height);
+
+    void build(const std::vector<std::uint8_t>& blocked, bool extend = true);  // blocked 按格子下标标记障碍物
+
+    int uncovered() const { return uncoveredCount; }  // 不在回路上的空闲格子数
+
+    int length() const { return cycleLength; }  // 回路上的格子数
+    bool contains(int x, int y) const { return order[index(x, y)] >= 0; }
+    int orderAt(int x, int y) const { return order[index(x, y)]; }  // 回路序号，不在回路上为 -1
+    Direction nextAt(int x, int y) const { return static_cast<Direction>(next[index(x, y)]); }
+    // 沿回路从 from 走到 to 的步数（0 ~ length - 1），两格都必须在回路上
+    int distance(std::pair<int, int> from, std::pair<int, int> to) const {
+        int d = orderAt(to.first, to.second) - orderAt(from.first, from.second);
+        return d < 0 ? d + cycleLength : d;
+    }
+
+private:
+    int width;
+    int height;
+    int cycleLength;
+    int uncoveredCount;
+    std::vector<int> order;
+    std::vector<std::uint8_t> next;
+
+    int index(int x, int y) const { return y * width + x; }
+    int spliceFreePairs(const std::vector<std::uint8_t>& blocked, const std::vector<int>& blocks, int blocksX);  // 返回并入的格子数
+};
+
+#endif // HAMILTONCYCLE_H
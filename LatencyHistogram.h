@@ -0,0 +1,118 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+// 单调时钟（纳秒），各处延迟统计共用的时间基准
+inline std::uint64_t steadyClockNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 对数-线性延迟直方图（纳秒）：每个 2 的幂区间再等分为 SUB_BUCKETS 份，
+// 相对误差不超过 1/SUB_BUCKETS，记录为 O(1)，占用固定内存，可以合并。
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() { clear(); }
+
+    void record(std::uint64_t ns) {
+        ++buckets[bucketIndex(ns)];
+        ++count;
+        total += ns;
+        minimum = std::min(minimum, ns);
+        maximum = std::max(maximum, ns);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+        total += other.total;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+    }
+
+    void clear() {
+        buckets.fill(0);
+        count = 0;
+        total = 0;
+        minimum = std::numeric_limits<std::uint64_t>::max();
+        maximum = 0;
+    }
+
+    std::uint64_t getCount() const { return count; }
+    std::uint64_t getMin() const { return count > 0 ? minimum : 0; }
+    std::uint64_t getMax() const { return maximum; }
+    double getMean() const { return count > 0 ? static_cast<double>(total) / count : 0.0; }
+
+    // 分位数（q 取 0~1），返回所在桶的上界，不超过记录到的最大值
+    std::uint64_t percentile(double q) const {
+        if (count == 0) return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(bucketUpper(i), maximum);
+        }
+        return maximum;
+    }
+
+    // 导出非空的桶，每行 "下界,上界,次数"（纳秒）
+    void write(std::ostream& out) const {
+        out << "lower_ns,upper_ns,count\n";
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            if (buckets[i] > 0) {
+                out << bucketLower(i) << ',' << bucketUpper(i) << ',' << buckets[i] << '\n';
+            }
+        }
+    }
+
+    static int bucketIndex(std::uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<int>(ns);
+        int bit = highestBit(ns);
+        int sub = static_cast<int>((ns >> (bit - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+        return (bit - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static std::uint64_t bucketLower(int index) {
+        if (index < SUB_BUCKETS) return static_cast<std::uint64_t>(index);
+        int octave = index / SUB_BUCKETS - 1;
+        return static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << octave;
+    }
+
+    static std::uint64_t bucketUpper(int index) {
+        if (index < SUB_BUCKETS) return static_cast<std::uint64_t>(index);
+        int octave = index / SUB_BUCKETS - 1;
+        return bucketLower(index) + ((std::uint64_t(1) << octave) - 1);
+    }
+
+private:
+    std::array<std::uint64_t, BUCKET_COUNT> buckets;
+    std::uint64_t count;
+    std::uint64_t total;
+    std::uint64_t minimum;
+    std::uint64_t maximum;
+
+    static int highestBit(std::uint64_t value) {
+        int bit = 0;
+        for (int shift = 32; shift > 0; shift >>= 1) {
+            if (value >> shift) {
+                value >>= shift;
+                bit += shift;
+            }
+        }
+        return bit;
+    }
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,119 @@
+#include "Leaderboard.h"
+#include "AtomicFile.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+// 文件格式（文本）：首行 "snake-leaderboard <版本>"，之后每行一局：分数 蛇长 难度 帧数 种子
+static const char* const HEADER = "snake-leaderboard";
+
+static bool ranksBefore(const LeaderboardEntry& a, const LeaderboardEntry& b) {
+    // 同分时用时短的在前
+    if (a.score != b.score) return a.score > b.score;
+    return a.durationTicks < b.durationTicks;
+}
+
+Leaderboard::Leaderboard(const std::string& filename)
+    : filename(filename), fileFound(false), revision(0), savedRevision(0), stopping(false) {
+    load();
+    writer = std::thread(&Leaderboard::run, this);
+}
+
+Leaderboard::~Leaderboard() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_one();
+    writer.join();
+}
+
+void Leaderboard::load() {
+    std::ifstream file(filename);
+    if (!file.is_open()) return;
+    fileFound = true;
+
+    std::string header;
+    int version = 0;
+    if (!(file >> header >> version) || header != HEADER || version != FORMAT_VERSION) return;
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line) && entries.size() < MAX_ENTRIES) {
+        std::istringstream in(line);
+        LeaderboardEntry entry;
+        unsigned difficulty = 0;
+        if (!(in >> entry.score >> entry.length >> difficulty >> entry.durationTicks >> entry.seed)) continue;
+        entry.difficulty = static_cast<std::uint8_t>(difficulty);
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(), ranksBefore);
+}
+
+bool Leaderboard::submit(const LeaderboardEntry& entry) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& existing : entries) {
+            if (existing.seed == entry.seed && existing.score == entry.score &&
+                existing.durationTicks == entry.durationTicks) {
+                return false;
+            }
+        }
+        auto position = std::upper_bound(entries.begin(), entries.end(), entry, ranksBefore);
+        if (position == entries.end() && entries.size() >= MAX_ENTRIES) return false;
+        entries.insert(position, entry);
+        if (entries.size() > MAX_ENTRIES) entries.pop_back();
+        ++revision;
+    }
+    changed.notify_one();
+    return true;
+}
+
+bool Leaderboard::importHighScore(const std::string& legacyFile) {
+    if (fileFound) return false;
+    std::ifstream file(legacyFile);
+    LeaderboardEntry entry;
+    if (!file.is_open() || !(file >> entry.score) || entry.score <= 0) return false;
+    entry.difficulty = 1;  // 旧版本只有分数，按默认的普通难度记录
+    return submit(entry);
+}
+
+std::vector<LeaderboardEntry> Leaderboard::getEntries() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries;
+}
+
+int Leaderboard::getBestScore() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.empty() ? 0 : entries.front().score;
+}
+
+void Leaderboard::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [&] { return stopping || revision != savedRevision; });
+        if (revision == savedRevision) break;  // 停止且没有未保存的更新
+
+        // 等一小段时间，把随后到来的更新合并到同一次写入
+        changed.wait_for(lock, std::chrono::milliseconds(COALESCE_MS), [&] { return stopping; });
+        std::vector<LeaderboardEntry> snapshot = entries;
+        std::uint64_t snapshotRevision = revision;
+
+        lock.unlock();
+        save(snapshot);  // 写失败时不重试，下次更新时整表重写
+        lock.lock();
+        savedRevision = snapshotRevision;
+    }
+}
+
+bool Leaderboard::save(const std::vector<LeaderboardEntry>& snapshot) const {
+    std::ostringstream out;
+    out << HEADER << ' ' << FORMAT_VERSION << '\n';
+    for (const auto& entry : snapshot) {
+        out << entry.score << ' ' << entry.length << ' ' << static_cast<unsigned>(entry.difficulty) << ' '
+            << entry.durationTicks << ' ' << entry.seed << '\n';
+    }
+    std::string text = out.str();
+    return AtomicFile::write(filename, text.data(), text.size());
+}
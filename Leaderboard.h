@@ -0,0 +1,58 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 排行榜中的一局
+struct LeaderboardEntry {
+    int score = 0;
+    int length = 0;                  // 结束时的蛇长
+    std::uint8_t difficulty = 0;     // 开局难度（Game::Difficulty）
+    std::uint64_t durationTicks = 0; // 对局进行的逻辑帧数
+    std::uint64_t seed = 0;          // 对局种子，可用于复现
+};
+
+// 持久化的排行榜（按分数保留前 MAX_ENTRIES 名）。
+// 构造时读取一次文件；submit 只修改内存并唤醒后台写线程，写线程合并短时间内的多次更新后原子写出。
+// 调用方（逻辑帧、界面）从不直接做文件读写。
+class Leaderboard {
+public:
+    static constexpr std::size_t MAX_ENTRIES = 10;
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr std::uint64_t COALESCE_MS = 500;  // 收到更新后等待合并的时长
+
+    explicit Leaderboard(const std::string& filename);  // 文件不存在或损坏时从空榜开始
+    ~Leaderboard();                                     // 写出尚未保存的更新后退出
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    bool submit(const LeaderboardEntry& entry);  // 进入榜单时返回 true；同一局（种子、分数、帧数相同）只记一次
+    // 旧版本只在 legacyFile（highscore.txt）中记一个最高分。排行榜文件还不存在（首次运行）时把它导入为一条记录，
+    // 之后排行榜文件已写出，不会再次导入。有记录导入时返回 true
+    bool importHighScore(const std::string& legacyFile);
+    std::vector<LeaderboardEntry> getEntries() const;  // 按分数从高到低
+    int getBestScore() const;
+    const std::string& getFilename() const { return filename; }
+
+private:
+    std::string filename;
+    bool fileFound;                         // 构造时排行榜文件是否存在
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<LeaderboardEntry> entries;  // 以下受 mutex 保护
+    std::uint64_t revision;                 // 每次修改榜单时递增
+    std::uint64_t savedRevision;            // 已写到磁盘的版本
+    bool stopping;
+    std::thread writer;
+
+    void load();
+    void run();
+    bool save(const std::vector<LeaderboardEntry>& snapshot) const;
+};
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// 只读内存映射文件：打开后直接按指针访问文件内容，不经过读缓冲区
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+    const unsigned char* bytes;
+    std::size_t length;
+};
+
+#endif // MAPPEDFILE_H
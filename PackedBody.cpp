@@ -0,0 +1,130 @@
+#include "PackedBody.h"
+#include <algorithm>
+
+PackedBody::PackedBody() : head(0, 0), tail(0, 0), length(0), tailRepeat(0) {
+}
+
+PackedBody::Segment PackedBody::step(Segment cell, Direction dir) {
+    switch (dir) {
+        case Direction::UP: --cell.second; break;
+        case Direction::DOWN: ++cell.second; break;
+        case Direction::LEFT: --cell.first; break;
+        case Direction::RIGHT: ++cell.first; break;
+    }
+    return cell;
+}
+
+bool PackedBody::directionBetween(Segment from, Segment to, Direction& dir) {
+    int dx = to.first - from.first;
+    int dy = to.second - from.second;
+    if (dx == 0 && dy == -1) dir = Direction::UP;
+    else if (dx == 0 && dy == 1) dir = Direction::DOWN;
+    else if (dx == -1 && dy == 0) dir = Direction::LEFT;
+    else if (dx == 1 && dy == 0) dir = Direction::RIGHT;
+    else return false;
+    return true;
+}
+
+void PackedBody::pack(const Snake& snake) {
+    auto body = snake.getBody();
+    length = static_cast<std::uint32_t>(body.size());
+    tailRepeat = 0;
+    bits.clear();
+    if (length == 0) return;
+    head = body.front();
+    tail = body.back();
+    // 蛇尾复制出的节与前一节重合，只计数
+    while (tailRepeat + 1 < length && body[length - 1 - tailRepeat] == body[length - 2 - tailRepeat]) {
+        ++tailRepeat;
+    }
+    std::size_t steps = chainLength();
+    bits.assign((steps + 3) / 4, 0);
+    // 活动的蛇除蛇尾外相邻两节总是相邻格子，方向可由坐标差直接查表：
+    // 竖直移动时 dy 为 ±1，(dy + 1) / 2 得到 UP/DOWN；水平移动时 2 + (dx + 1) / 2 得到 LEFT/RIGHT
+    auto it = body.begin();
+    Segment previous = *it;
+    for (std::size_t i = 0; i < steps; ++i) {
+        Segment cell = *++it;
+        int dx = cell.first - previous.first;
+        int dy = cell.second - previous.second;
+        unsigned dir = dx == 0 ? static_cast<unsigned>(dy + 1) / 2 : 2 + static_cast<unsigned>(dx + 1) / 2;
+        bits[i >> 2] = static_cast<std::uint8_t>(bits[i >> 2] | (dir << ((i & 3) * 2)));
+        previous = cell;
+    }
+}
+
+bool PackedBody::pack(const std::vector<Segment>& body) {
+    std::uint32_t repeat = 0;
+    std::size_t count = body.size();
+    while (repeat + 1 < count && body[count - 1 - repeat] == body[count - 2 - repeat]) {
+        ++repeat;
+    }
+    std::size_t steps = count == 0 ? 0 : count - 1 - repeat;
+    Direction dir = Direction::UP;
+    for (std::size_t i = 0; i < steps; ++i) {
+        if (!directionBetween(body[i], body[i + 1], dir)) return false;
+    }
+
+    length = static_cast<std::uint32_t>(count);
+    tailRepeat = repeat;
+    bits.assign((steps + 3) / 4, 0);
+    if (count == 0) return true;
+    head = body.front();
+    tail = body.back();
+    for (std::size_t i = 0; i < steps; ++i) {
+        directionBetween(body[i], body[i + 1], dir);
+        setDirection(i, dir);
+    }
+    return true;
+}
+
+void PackedBody::unpack(std::vector<Segment>& body) const {
+    static const int DX[4] = {0, 0, -1, 1};
+    static const int DY[4] = {-1, 1, 0, 0};
+    body.resize(length);
+    if (length == 0) return;
+    // 每次取一个字节解出 4 步，避免逐步移位取位
+    Segment cell = head;
+    body[0] = cell;
+    std::size_t steps = chainLength();
+    std::size_t i = 0;
+    for (; i + 4 <= steps; i += 4) {
+        unsigned byte = bits[i >> 2];
+        for (int k = 0; k < 4; ++k, byte >>= 2) {
+            cell.first += DX[byte & 3];
+            cell.second += DY[byte & 3];
+            body[i + k + 1] = cell;
+        }
+    }
+    for (; i < steps; ++i) {
+        unsigned dir = static_cast<unsigned>(directionAt(i));
+        cell.first += DX[dir];
+        cell.second += DY[dir];
+        body[i + 1] = cell;
+    }
+    for (std::size_t j = steps + 1; j < length; ++j) {
+        body[j] = cell;
+    }
+}
+
+PackedBody::Segment PackedBody::at(std::size_t index) const {
+    Segment cell = head;
+    std::size_t steps = std::min(index, chainLength());
+    for (std::size_t i = 0; i < steps; ++i) {
+        cell = step(cell, directionAt(i));
+    }
+    return cell;
+}
+
+bool PackedBody::assign(Segment newHead, std::uint32_t newLength, std::uint32_t newTailRepeat,
+                        const std::uint8_t* newBits, std::size_t byteCount) {
+    if (newLength == 0 || newTailRepeat >= newLength) return false;
+    std::size_t steps = newLength - 1 - newTailRepeat;
+    if (byteCount != (steps + 3) / 4) return false;
+    head = newHead;
+    length = newLength;
+    tailRepeat = newTailRepeat;
+    bits.assign(newBits, newBits + byteCount);
+    tail = at(steps);
+    return true;
+}
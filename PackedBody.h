@@ -0,0 +1,69 @@
+#ifndef PACKEDBODY_H
+#define PACKEDBODY_H
+
+#include "Snake.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 紧凑的蛇身：蛇头坐标加每节 2 位的方向链（从前一节走到这一节的方向），
+// 蛇尾因吃到食物而复制出的重叠节只记个数。每节约 0.25 字节，而坐标数组每节 8 字节。
+// 用于存档、画面快照和回退关键帧等需要复制整条蛇身的地方。
+class PackedBody {
+public:
+    using Segment = std::pair<int, int>;
+
+    PackedBody();
+
+    void pack(const Snake& snake);                 // 从活动的蛇打包，复用已有容量
+    bool pack(const std::vector<Segment>& body);   // 中间有不相邻的两节时返回 false，内容不变
+    void unpack(std::vector<Segment>& body) const; // 解包为从头到尾的坐标
+
+    // 从头到尾依次访问每一节，不分配内存
+    template<typename F>
+    void forEach(F&& f) const {
+        if (length == 0) return;
+        Segment cell = head;
+        f(cell);
+        std::size_t steps = chainLength();
+        for (std::size_t i = 0; i < steps; ++i) {
+            cell = step(cell, directionAt(i));
+            f(cell);
+        }
+        for (std::uint32_t i = 0; i < tailRepeat; ++i) {
+            f(cell);
+        }
+    }
+
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    Segment front() const { return head; }
+    Segment back() const { return tail; }
+    Segment at(std::size_t index) const;           // 第 index 节，O(index)
+    std::uint32_t getTailRepeat() const { return tailRepeat; }
+    std::size_t chainLength() const { return length == 0 ? 0 : length - 1 - tailRepeat; }  // 方向链的步数
+    Direction directionAt(std::size_t i) const {
+        return static_cast<Direction>((bits[i >> 2] >> ((i & 3) * 2)) & 3);
+    }
+    const std::vector<std::uint8_t>& getBits() const { return bits; }  // 方向链，每字节 4 步，低位在前
+    std::size_t byteSize() const { return bits.capacity(); }           // 方向链占用的字节数
+
+    // 按存档中的字段重建，方向链长度与字节数不符时返回 false
+    bool assign(Segment head, std::uint32_t length, std::uint32_t tailRepeat, const std::uint8_t* bits, std::size_t byteCount);
+
+private:
+    Segment head;
+    Segment tail;
+    std::uint32_t length;
+    std::uint32_t tailRepeat;              // 蛇尾与前一节重合的节数
+    std::vector<std::uint8_t> bits;
+
+    static Segment step(Segment cell, Direction dir);
+    void setDirection(std::size_t i, Direction dir) {
+        bits[i >> 2] = static_cast<std::uint8_t>(bits[i >> 2] | (static_cast<unsigned>(dir) << ((i & 3) * 2)));
+    }
+    static bool directionBetween(Segment from, Segment to, Direction& dir);
+};
+
+#endif // PACKEDBODY_H
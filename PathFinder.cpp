@@ -0,0 +1,31 @@
+#include "PathFinder.h"
+#include <algorithm>
+
+PathFinder::PathFinder(int width, int height)
+    : width(width), height(height),
+      visited((static_cast<std::size_t>(width) * height + 63) / 64, 0) {
+    // 每个格子最多入队一次；小棋盘一次性分配足够的节点空间，
+    // 大棋盘按需增长，容量在后续搜索中保留
+    std::size_t cells = static_cast<std::size_t>(width) * height;
+    nodes.reserve(std::min<std::size_t>(cells, MAX_RESERVED_NODES));
+}
+
+void PathFinder::reset() {
+    nodes.clear();
+    std::fill(visited.begin(), visited.end(), 0);
+}
+
+bool PathFinder::testAndSetVisited(int cell) {
+    std::uint64_t& word = visited[static_cast<std::size_t>(cell) >> 6];
+    std::uint64_t mask = std::uint64_t(1) << (cell & 63);
+    bool wasVisited = (word & mask) != 0;
+    word |= mask;
+    return wasVisited;
+}
+
+void PathFinder::buildPath(int nodeIndex, std::vector<Direction>& path) const {
+    path.resize(static_cast<std::size_t>(nodes[nodeIndex].depth));
+    for (int i = nodeIndex; nodes[i].parent >= 0; i = nodes[i].parent) {
+        path[static_cast<std::size_t>(nodes[i].depth) - 1] = nodes[i].dir;
+    }
+}
@@ -0,0 +1,199 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include "Snake.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+// 网格 BFS 寻路器
+// 搜索节点保存在预分配的数组中（同时充当 BFS 队列），每个节点只记录父节点下标，
+// 找到目标后才回溯出完整路径；已访问格子使用按位存储的集合。
+// 构造后重复搜索不会再分配内存。
+class PathFinder {
+public:
+    PathFinder(int width, int height);
+
+    // 从 start 搜索到 goal 的最短路径，结果写入 path（不含起点）。
+    // passable(x, y, step) 判断第 step 步（从 1 开始）能否进入格子 (x, y)，越界检查由寻路器完成。
+    // 已访问集合按格子而不是按（格子, 到达步数）记录，每个格子只保留最早的到达：
+    // passable 对 step 单调（某步能进入的格子之后每一步都能进入，如蛇身按离开帧数标记）时，
+    // 最早到达能走的后续路线晚到达也都能走，搜索是精确的；不单调时搜索是保守的，
+    // 只在较晚到达某格时才走得通的路线会被漏掉，但找到的路径每一步都满足 passable。
+    template <typename Passable>
+    bool findPath(std::pair<int, int> start, std::pair<int, int> goal,
+                  Passable passable, std::vector<Direction>& path) {
+        return findPath(start, goal, passable, path, [] { return false; });
+    }
+
+    // 可取消的版本：每扩展 CANCEL_CHECK_INTERVAL 个节点调用一次 cancelled()，返回 true 时放弃搜索
+    template <typename Passable, typename Cancelled>
+    bool findPath(std::pair<int, int> start, std::pair<int, int> goal,
+                  Passable passable, std::vector<Direction>& path, Cancelled cancelled);
+
+    // 有界搜索：从 start 出发找最近的满足 isGoal(x, y, step) 的格子，最多扩展 maxNodes 个节点，用于路径的局部修复。
+    // 目标格子不要求 passable；不满足 isGoal 的格子之后可能在更深的步数上满足，因此不标记为已访问。
+    template <typename Goal, typename Passable>
+    bool findDetour(std::pair<int, int> start, Goal isGoal, Passable passable,
+                    std::vector<Direction>& path, std::size_t maxNodes);
+
+    // 时间感知寻路用的蛇身标记：第 i 节（蛇头为 0）在移动 n - i 步后离开所在格子，
+    // 同一格子有多节重叠时取最晚的一节。releaseTicks 按格子下标存放，未标记的格子为 0。
+    template <typename Body>
+    static void labelReleaseTicks(const Body& body, int width, int height, std::vector<int>& releaseTicks);
+    template <typename Body>
+    static void clearReleaseTicks(const Body& body, int width, int height, std::vector<int>& releaseTicks);
+
+private:
+    struct Node {
+        std::int32_t cell;    // 格子下标 y * width + x
+        std::int32_t parent;  // 父节点在 nodes 中的下标，起点为 -1
+        std::int32_t depth;   // 从起点出发的步数
+        Direction dir;        // 从父节点到达该节点的方向
+    };
+
+    static constexpr std::size_t MAX_RESERVED_NODES = 1 << 16;  // 构造时预留的最大节点数
+    static constexpr std::size_t CANCEL_CHECK_INTERVAL = 1024;
+
+    int width;
+    int height;
+    std::vector<Node> nodes;            // 节点数组，按入队顺序排列
+    std::vector<std::uint64_t> visited; // 已访问格子位集合
+
+    void reset();
+    bool testAndSetVisited(int cell);
+    void buildPath(int nodeIndex, std::vector<Direction>& path) const;
+};
+
+template <typename Passable, typename Cancelled>
+bool PathFinder::findPath(std::pair<int, int> start, std::pair<int, int> goal,
+                          Passable passable, std::vector<Direction>& path, Cancelled cancelled) {
+    static const Direction DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static const int DX[4] = {0, 0, -1, 1};
+    static const int DY[4] = {-1, 1, 0, 0};
+
+    path.clear();
+    reset();
+    if (start.first < 0 || start.first >= width || start.second < 0 || start.second >= height) {
+        return false;
+    }
+
+    int startCell = start.second * width + start.first;
+    int goalCell = goal.second * width + goal.first;
+    testAndSetVisited(startCell);
+    nodes.push_back({startCell, -1, 0, Direction::RIGHT});
+
+    // nodes 即队列：front 指向下一个待扩展的节点
+    for (std::size_t front = 0; front < nodes.size(); ++front) {
+        if (front % CANCEL_CHECK_INTERVAL == CANCEL_CHECK_INTERVAL - 1 && cancelled()) {
+            return false;
+        }
+        const Node current = nodes[front];
+        if (current.cell == goalCell) {
+            buildPath(static_cast<int>(front), path);
+            return true;
+        }
+
+        int x = current.cell % width;
+        int y = current.cell / width;
+
+        // 按到目标的曼哈顿距离排序，优先朝目标方向扩展
+        int order[4] = {0, 1, 2, 3};
+        int distance[4];
+        for (int i = 0; i < 4; ++i) {
+            distance[i] = std::abs(x + DX[i] - goal.first) + std::abs(y + DY[i] - goal.second);
+        }
+        for (int i = 1; i < 4; ++i) {
+            int key = order[i];
+            int j = i - 1;
+            while (j >= 0 && distance[order[j]] > distance[key]) {
+                order[j + 1] = order[j];
+                --j;
+            }
+            order[j + 1] = key;
+        }
+
+        for (int k = 0; k < 4; ++k) {
+            int i = order[k];
+            int nx = x + DX[i];
+            int ny = y + DY[i];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                continue;
+            }
+            int cell = ny * width + nx;
+            if (!passable(nx, ny, current.depth + 1) || testAndSetVisited(cell)) {
+                continue;
+            }
+            nodes.push_back({cell, static_cast<std::int32_t>(front), current.depth + 1, DIRECTIONS[i]});
+        }
+    }
+    return false;
+}
+
+template <typename Goal, typename Passable>
+bool PathFinder::findDetour(std::pair<int, int> start, Goal isGoal, Passable passable,
+                            std::vector<Direction>& path, std::size_t maxNodes) {
+    static const Direction DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static const int DX[4] = {0, 0, -1, 1};
+    static const int DY[4] = {-1, 1, 0, 0};
+
+    path.clear();
+    reset();
+    if (start.first < 0 || start.first >= width || start.second < 0 || start.second >= height) {
+        return false;
+    }
+
+    testAndSetVisited(start.second * width + start.first);
+    nodes.push_back({start.second * width + start.first, -1, 0, Direction::RIGHT});
+
+    for (std::size_t front = 0; front < nodes.size() && nodes.size() < maxNodes; ++front) {
+        const Node current = nodes[front];
+        int x = current.cell % width;
+        int y = current.cell / width;
+        for (int i = 0; i < 4; ++i) {
+            int nx = x + DX[i];
+            int ny = y + DY[i];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                continue;
+            }
+            int cell = ny * width + nx;
+            if (isGoal(nx, ny, current.depth + 1)) {
+                nodes.push_back({cell, static_cast<std::int32_t>(front), current.depth + 1, DIRECTIONS[i]});
+                buildPath(static_cast<int>(nodes.size()) - 1, path);
+                return true;
+            }
+            if (!passable(nx, ny, current.depth + 1) || testAndSetVisited(cell)) {
+                continue;
+            }
+            nodes.push_back({cell, static_cast<std::int32_t>(front), current.depth + 1, DIRECTIONS[i]});
+        }
+    }
+    return false;
+}
+
+template <typename Body>
+void PathFinder::labelReleaseTicks(const Body& body, int width, int height, std::vector<int>& releaseTicks) {
+    int length = static_cast<int>(body.size());
+    int index = 0;
+    for (const auto& segment : body) {
+        if (segment.first >= 0 && segment.first < width && segment.second >= 0 && segment.second < height) {
+            int& label = releaseTicks[static_cast<std::size_t>(segment.second) * width + segment.first];
+            label = std::max(label, length - index);
+        }
+        ++index;
+    }
+}
+
+template <typename Body>
+void PathFinder::clearReleaseTicks(const Body& body, int width, int height, std::vector<int>& releaseTicks) {
+    // 只清理蛇身占据的格子，其余格子始终为 0
+    for (const auto& segment : body) {
+        if (segment.first >= 0 && segment.first < width && segment.second >= 0 && segment.second < height) {
+            releaseTicks[static_cast<std::size_t>(segment.second) * width + segment.first] = 0;
+        }
+    }
+}
+
+#endif // PATHFINDER_H
@@ -0,0 +1,79 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// 可设定种子的快速伪随机数生成器（xoshiro256**）
+// 同一种子总是产生同一序列，状态只有 4 个 64 位整数，可以直接保存和恢复。
+class Random {
+public:
+    struct State {
+        std::uint64_t s[4];
+    };
+
+    explicit Random(std::uint64_t seed = 1) { reseed(seed); }
+
+    void reseed(std::uint64_t seed) {
+        // 用 splitmix64 展开种子，保证状态不全为 0
+        for (auto& word : state.s) {
+            word = splitMix64(seed);
+        }
+    }
+
+    std::uint64_t next() {
+        std::uint64_t* s = state.s;
+        std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // [0, bound) 内均匀分布的整数（Lemire 乘法取高位，拒绝有偏区间）
+    std::uint32_t uniform(std::uint32_t bound) {
+        std::uint64_t product = static_cast<std::uint64_t>(static_cast<std::uint32_t>(next() >> 32)) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = static_cast<std::uint64_t>(static_cast<std::uint32_t>(next() >> 32)) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // [min, max] 内均匀分布的整数
+    int range(int min, int max) {
+        return min + static_cast<int>(uniform(static_cast<std::uint32_t>(max - min + 1)));
+    }
+
+    // [0, 1) 内均匀分布的浮点数
+    double nextDouble() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    const State& getState() const { return state; }
+    void setState(const State& newState) { state = newState; }
+
+    // splitmix64：推进 x 并返回混合后的值，也用于由一个种子派生多个种子
+    static std::uint64_t splitMix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    State state;
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,166 @@
+#include "Replay.h"
+#include "game.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char MAGIC[4] = {'S', 'N', 'K', 'R'};
+
+void putInt(std::vector<char>& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// 变长整数：每字节 7 位，最高位表示后面还有字节
+void putVarint(std::vector<char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+class Reader {
+public:
+    Reader(const std::vector<char>& data) : data(data), pos(0), ok(true) {}
+
+    std::uint64_t getInt(int bytes) {
+        if (pos + bytes > data.size()) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::uint64_t getVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint64_t byte = getInt(1);
+            value |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    const std::vector<char>& data;
+    std::size_t pos;
+    bool ok;
+};
+
+} // namespace
+
+bool Replay::save(const std::string& filename) const {
+    std::vector<char> out(MAGIC, MAGIC + 4);
+    putInt(out, version, 2);
+    putInt(out, static_cast<std::uint64_t>(width), 2);
+    putInt(out, static_cast<std::uint64_t>(height), 2);
+    putInt(out, difficulty, 1);
+    putInt(out, (alwaysAutoPath ? 1 : 0) | (strategy << 1), 1);
+    putInt(out, seed, 8);
+    putInt(out, endTick, 8);
+    putInt(out, endHash, 8);
+    putInt(out, static_cast<std::uint32_t>(endScore), 4);
+    putInt(out, events.size(), 4);
+
+    // 输入按帧差值存储，每个输入通常只占 2 个字节
+    std::uint64_t previousTick = 0;
+    for (const auto& event : events) {
+        putVarint(out, event.tick - previousTick);
+        putInt(out, (static_cast<unsigned>(event.kind) << 4) | (event.value & 0x0F), 1);
+        previousTick = event.tick;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+bool Replay::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < 4 || !std::equal(MAGIC, MAGIC + 4, data.begin())) return false;
+    std::vector<char> body(data.begin() + 4, data.end());
+    Reader in(body);
+    std::uint64_t version = in.getInt(2);
+    if (version < 1 || version > FORMAT_VERSION) return false;
+
+    Replay loaded;
+    loaded.version = static_cast<std::uint16_t>(version);
+    loaded.width = static_cast<int>(in.getInt(2));
+    loaded.height = static_cast<int>(in.getInt(2));
+    loaded.difficulty = static_cast<std::uint8_t>(in.getInt(1));
+    std::uint8_t autoPathFlags = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.alwaysAutoPath = (autoPathFlags & 1) != 0;
+    loaded.strategy = version >= 2 ? static_cast<std::uint8_t>(autoPathFlags >> 1) : 0;
+    loaded.seed = in.getInt(8);
+    loaded.endTick = in.getInt(8);
+    loaded.endHash = in.getInt(8);
+    loaded.endScore = static_cast<std::int32_t>(static_cast<std::uint32_t>(in.getInt(4)));
+    std::uint64_t count = in.getInt(4);
+    if (!in.good() || loaded.difficulty > static_cast<std::uint8_t>(Game::Difficulty::HARD) ||
+        loaded.strategy > static_cast<std::uint8_t>(Game::AutoPathStrategy::HAMILTON)) {
+        return false;
+    }
+
+    std::uint64_t tick = 0;
+    for (std::uint64_t i = 0; i < count && in.good(); ++i) {
+        tick += in.getVarint();
+        std::uint8_t packed = static_cast<std::uint8_t>(in.getInt(1));
+        ReplayEvent event = {tick, static_cast<ReplayEvent::Kind>(packed >> 4), static_cast<std::uint8_t>(packed & 0x0F)};
+        if (event.kind != ReplayEvent::Kind::DIRECTION && event.kind != ReplayEvent::Kind::DIFFICULTY) return false;
+        loaded.events.push_back(event);
+    }
+    if (!in.good() || !in.atEnd()) return false;
+
+    *this = loaded;
+    return true;
+}
+
+// 推进到指定帧，对局提前结束时停止
+static void fastForward(Game& game, std::uint64_t tick) {
+    while (game.getTickCount() < tick && !game.isGameOver()) {
+        std::uint64_t remaining = tick - game.getTickCount();
+        if (game.step(static_cast<int>(std::min<std::uint64_t>(remaining, INT_MAX))) == 0) break;
+    }
+}
+
+std::unique_ptr<Game> Replay::play(std::uint64_t untilTick) const {
+    GameConfig config;
+    config.board = BoardSize(width, height);
+    config.difficulty = static_cast<Game::Difficulty>(difficulty);
+    config.seed = seed;
+    config.alwaysAutoPath = alwaysAutoPath;
+    config.autoPathStrategy = static_cast<Game::AutoPathStrategy>(strategy);
+    config.autopilotRevision = revisionForVersion(version);
+    std::unique_ptr<Game> game(new Game(config));
+
+    std::uint64_t lastTick = std::min(untilTick, endTick);
+    for (const auto& event : events) {
+        if (event.tick > lastTick) break;
+        fastForward(*game, event.tick);
+        if (game->getTickCount() != event.tick) break;
+        game->applyReplayEvent(event);
+    }
+    fastForward(*game, lastTick);
+    return game;
+}
+
+bool Replay::matches(const Game& game) const {
+    return game.getTickCount() == endTick && game.getStateHash() == endHash && game.getScore() == endScore;
+}
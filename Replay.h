@@ -0,0 +1,58 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Game;
+
+// 对局中的一次外部输入
+struct ReplayEvent {
+    enum class Kind : std::uint8_t {
+        DIRECTION,   // 改变方向，value 为 Direction
+        DIFFICULTY   // 切换难度（会重新生成障碍物），value 为 Game::Difficulty
+    };
+
+    std::uint64_t tick;  // 输入发生时已执行的逻辑帧数，回放时在推进到该帧后施加
+    Kind kind;
+    std::uint8_t value;
+};
+
+// 对局录像：只记录初始配置（含种子）和稀疏的输入列表，
+// 回放时在无界面的 Game 上按帧重放，可以任意快进。
+class Replay {
+public:
+    // 版本 2 起自动寻路标志字节的高位记录寻路策略；版本 3 ~ 6 格式不变，
+    // 只表示录制时的自动寻路修订号（Game::AUTOPILOT_REVISION）分别为 1 ~ 4
+    static constexpr std::uint16_t FORMAT_VERSION = 6;
+
+    std::uint16_t version = FORMAT_VERSION;  // 读入的录像版本，决定回放时的自动寻路行为
+
+    int width = 0;
+    int height = 0;
+    std::uint8_t difficulty = 0;
+    bool alwaysAutoPath = false;
+    std::uint8_t strategy = 0;  // Game::AutoPathStrategy
+    std::uint64_t seed = 0;
+    std::vector<ReplayEvent> events;
+
+    // 录制结束时的对局状态，用于回放后校验
+    std::uint64_t endTick = 0;
+    std::uint64_t endHash = 0;
+    int endScore = 0;
+
+    static std::uint16_t versionForRevision(int autopilotRevision) { return static_cast<std::uint16_t>(2 + autopilotRevision); }
+    static int revisionForVersion(std::uint16_t version) { return version <= 2 ? 0 : version - 2; }
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    // 从初始状态回放到第 untilTick 帧（不超过录制结束的帧），返回回放后的对局
+    std::unique_ptr<Game> play(std::uint64_t untilTick = UINT64_MAX) const;
+    // 回放后的对局是否与录制结束时一致
+    bool matches(const Game& game) const;
+};
+
+#endif // REPLAY_H
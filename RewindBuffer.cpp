@@ -0,0 +1,268 @@
+#include "RewindBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 增量的字段掩码
+enum : std::uint8_t {
+    HEAD = 1,       // 蛇头前进一格：新蛇头坐标，蛇身为新蛇头加旧蛇身去掉末节
+    GREW = 2,       // 随后蛇尾复制一节（吃到食物）
+    FOOD = 4,       // 食物位置和类型
+    SCORE = 8,      // 分数和最高分
+    RNG = 16,       // 随机数状态
+    STATUS = 32     // 方向、结果、难度、暂停和自动寻路
+};
+
+void putInt(std::vector<unsigned char>& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<unsigned char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+std::uint64_t getInt(const unsigned char*& p, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(*p++) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+std::uint64_t getVarint(const unsigned char*& p) {
+    std::uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        unsigned char byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+}
+
+bool sameRng(const Random::State& a, const Random::State& b) {
+    return std::memcmp(a.s, b.s, sizeof(a.s)) == 0;
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(std::size_t budgetBytes) : budgetBytes(budgetBytes), memoryUsed(0) {
+}
+
+void RewindBuffer::clear() {
+    segments.clear();
+    memoryUsed = 0;
+}
+
+std::uint64_t RewindBuffer::getOldestTick() const {
+    return segments.empty() ? 0 : segments.front().keyFrame.tick;
+}
+
+bool RewindBuffer::needsKeyframe(const RewindFrame& frame) const {
+    if (segments.empty() || segments.back().count >= KEYFRAME_INTERVAL) return true;
+    if (frame.tick != last.tick + 1 || frame.obstacleHash != last.obstacleHash) return true;
+    // 蛇身只能是"新蛇头 + 旧蛇身去掉末节"（吃到食物时再复制一节蛇尾），或者完全不动
+    if (frame.head == last.head) return frame.length != last.length || frame.grew;
+    bool continuous = frame.length == 1 || frame.neck == last.head;
+    return !continuous || frame.length != last.length + (frame.grew ? 1 : 0);
+}
+
+std::size_t RewindBuffer::keyframeBytes(const Segment& segment) {
+    const GameState& state = segment.keyframe;
+    return sizeof(Segment) + (state.body.capacity() + state.obstacles.capacity()) * sizeof(std::pair<int, int>) +
+           state.path.capacity() + segment.packedBody.byteSize();
+}
+
+void RewindBuffer::addKeyframe(const GameState& state, const RewindFrame& frame) {
+    if (!isEnabled()) return;
+    // 关键帧之前的段已满或被截断，把其增量缓冲收紧后再计入
+    if (!segments.empty()) {
+        Segment& previous = segments.back();
+        memoryUsed -= previous.deltas.capacity();
+        previous.deltas.shrink_to_fit();
+        memoryUsed += previous.deltas.capacity();
+    }
+    segments.emplace_back();
+    Segment& segment = segments.back();
+    segment.keyframe = state;
+    segment.keyframe.path = std::vector<std::uint8_t>();
+    // 蛇身按方向链保存，每节约 0.25 字节
+    if (segment.packedBody.pack(state.body)) {
+        segment.keyframe.body = std::vector<std::pair<int, int>>();
+    }
+    segment.keyFrame = frame;
+    segment.deltas.reserve(KEYFRAME_INTERVAL * 8);
+    segment.bytes = keyframeBytes(segment);
+    memoryUsed += segment.bytes + segment.deltas.capacity();
+    last = frame;
+    evict();
+}
+
+void RewindBuffer::addDelta(const RewindFrame& frame) {
+    if (!isEnabled()) return;
+    Segment& segment = segments.back();
+    std::size_t capacity = segment.deltas.capacity();
+    encode(last, frame, segment.deltas);
+    memoryUsed += segment.deltas.capacity() - capacity;
+    ++segment.count;
+    last = frame;
+    evict();
+}
+
+void RewindBuffer::evict() {
+    // 至少保留正在记录的一段
+    while (memoryUsed > budgetBytes && segments.size() > 1) {
+        memoryUsed -= segments.front().bytes + segments.front().deltas.capacity();
+        segments.pop_front();
+    }
+}
+
+void RewindBuffer::encode(const RewindFrame& previous, const RewindFrame& frame, std::vector<unsigned char>& out) {
+    std::uint8_t mask = 0;
+    if (frame.head != previous.head) mask |= HEAD;
+    if (frame.grew) mask |= GREW;
+    if (frame.food != previous.food || frame.foodType != previous.foodType) mask |= FOOD;
+    if (frame.score != previous.score || frame.highScore != previous.highScore) mask |= SCORE;
+    if (!sameRng(frame.rng, previous.rng)) mask |= RNG;
+    if (frame.direction != previous.direction || frame.outcome != previous.outcome ||
+        frame.difficulty != previous.difficulty || frame.paused != previous.paused ||
+        frame.autoPathEnabled != previous.autoPathEnabled || frame.autoPathStartTick != previous.autoPathStartTick) {
+        mask |= STATUS;
+    }
+
+    out.push_back(mask);
+    if (mask & HEAD) {
+        // 蛇头可能越界一格（撞墙的那一帧），按有符号 16 位存
+        putInt(out, static_cast<std::uint16_t>(frame.head.first), 2);
+        putInt(out, static_cast<std::uint16_t>(frame.head.second), 2);
+    }
+    if (mask & FOOD) {
+        putInt(out, static_cast<std::uint16_t>(frame.food.first), 2);
+        putInt(out, static_cast<std::uint16_t>(frame.food.second), 2);
+        out.push_back(frame.foodType);
+    }
+    if (mask & SCORE) {
+        putVarint(out, static_cast<std::uint32_t>(frame.score));
+        putVarint(out, static_cast<std::uint32_t>(frame.highScore));
+    }
+    if (mask & RNG) {
+        for (std::uint64_t word : frame.rng.s) {
+            putInt(out, word, 8);
+        }
+    }
+    if (mask & STATUS) {
+        out.push_back(frame.direction);
+        out.push_back(frame.outcome);
+        out.push_back(frame.difficulty);
+        out.push_back(static_cast<unsigned char>((frame.paused ? 1 : 0) | (frame.autoPathEnabled ? 2 : 0)));
+        putVarint(out, frame.autoPathStartTick);
+    }
+}
+
+std::size_t RewindBuffer::decode(const unsigned char* data, const RewindFrame& previous, RewindFrame& frame) {
+    const unsigned char* p = data;
+    std::uint8_t mask = *p++;
+    frame = previous;
+    frame.tick = previous.tick + 1;
+    frame.grew = (mask & GREW) != 0;
+    if (mask & HEAD) {
+        frame.head.first = static_cast<std::int16_t>(getInt(p, 2));
+        frame.head.second = static_cast<std::int16_t>(getInt(p, 2));
+        frame.length = previous.length + (frame.grew ? 1 : 0);
+    }
+    if (mask & FOOD) {
+        frame.food.first = static_cast<std::int16_t>(getInt(p, 2));
+        frame.food.second = static_cast<std::int16_t>(getInt(p, 2));
+        frame.foodType = *p++;
+    }
+    if (mask & SCORE) {
+        frame.score = static_cast<std::int32_t>(static_cast<std::uint32_t>(getVarint(p)));
+        frame.highScore = static_cast<std::int32_t>(static_cast<std::uint32_t>(getVarint(p)));
+    }
+    if (mask & RNG) {
+        for (std::uint64_t& word : frame.rng.s) {
+            word = getInt(p, 8);
+        }
+    }
+    if (mask & STATUS) {
+        frame.direction = *p++;
+        frame.outcome = *p++;
+        frame.difficulty = *p++;
+        frame.paused = (*p & 1) != 0;
+        frame.autoPathEnabled = (*p & 2) != 0;
+        ++p;
+        frame.autoPathStartTick = getVarint(p);
+    }
+    return static_cast<std::size_t>(p - data);
+}
+
+bool RewindBuffer::stateAt(std::uint64_t tick, GameState& state) const {
+    if (segments.empty() || tick < getOldestTick() || tick > last.tick) return false;
+    auto segment = std::upper_bound(segments.begin(), segments.end(), tick,
+        [](std::uint64_t t, const Segment& s) { return t < s.keyFrame.tick; });
+    --segment;
+
+    // 蛇身用双端队列逐帧推进：前面压入新蛇头，后面弹出末节
+    std::deque<std::pair<int, int>> body(segment->keyframe.body.begin(), segment->keyframe.body.end());
+    if (!segment->packedBody.empty()) {
+        segment->packedBody.forEach([&](const std::pair<int, int>& cell) { body.push_back(cell); });
+    }
+    RewindFrame frame = segment->keyFrame;
+    const unsigned char* p = segment->deltas.data();
+    while (frame.tick < tick) {
+        RewindFrame next;
+        p += decode(p, frame, next);
+        if (next.head != frame.head) {
+            body.push_front(next.head);
+            body.pop_back();
+            if (next.grew) body.push_back(body.back());
+        }
+        frame = next;
+    }
+
+    state = segment->keyframe;
+    state.body.assign(body.begin(), body.end());
+    state.tickCount = frame.tick;
+    state.food = frame.food;
+    state.foodType = frame.foodType;
+    state.score = frame.score;
+    state.highScore = frame.highScore;
+    state.direction = frame.direction;
+    state.outcome = frame.outcome;
+    state.difficulty = frame.difficulty;
+    state.paused = frame.paused;
+    state.autoPathEnabled = frame.autoPathEnabled;
+    state.autoPathStartTick = frame.autoPathStartTick;
+    state.rng = frame.rng;
+    return true;
+}
+
+void RewindBuffer::truncateAfter(std::uint64_t tick) {
+    if (segments.empty() || tick >= last.tick) return;
+    while (segments.size() > 1 && segments.back().keyFrame.tick > tick) {
+        memoryUsed -= segments.back().bytes + segments.back().deltas.capacity();
+        segments.pop_back();
+    }
+    Segment& segment = segments.back();
+    if (segment.keyFrame.tick > tick) {
+        clear();
+        return;
+    }
+
+    // 在段内找到该帧增量的结尾，截掉之后的增量
+    RewindFrame frame = segment.keyFrame;
+    std::size_t offset = 0;
+    while (frame.tick < tick) {
+        RewindFrame next;
+        offset += decode(segment.deltas.data() + offset, frame, next);
+        frame = next;
+    }
+    segment.deltas.resize(offset);
+    segment.count = static_cast<std::uint32_t>(frame.tick - segment.keyFrame.tick);
+    last = frame;
+}
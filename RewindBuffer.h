@@ -0,0 +1,77 @@
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include "GameState.h"
+#include "PackedBody.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+// 一个逻辑帧之后局面中逐帧可能变化的字段；蛇身只记蛇头和长度
+struct RewindFrame {
+    std::uint64_t tick = 0;
+    std::pair<int, int> head;
+    std::pair<int, int> neck;           // 蛇身第二节（蛇长为 1 时同蛇头），只用来判断能否写成增量，不记录
+    std::uint32_t length = 0;
+    bool grew = false;                  // 本帧吃到食物，蛇尾复制了一节
+    std::pair<int, int> food;
+    std::uint8_t foodType = 0;
+    std::int32_t score = 0;
+    std::int32_t highScore = 0;
+    std::uint8_t direction = 0;
+    std::uint8_t outcome = 0;
+    std::uint8_t difficulty = 0;
+    bool paused = false;
+    bool autoPathEnabled = false;
+    std::uint64_t autoPathStartTick = 0;
+    Random::State rng = {};
+    std::uint64_t obstacleHash = 0;
+};
+
+// 回退缓冲区：按段保存最近的对局历史，每段是一个完整关键帧加其后逐帧的增量。
+// 增量按字段掩码变长编码，通常只有蛇头一项（几个字节）；障碍物变化或蛇身无法用"新蛇头 + 保留旧蛇身"
+// 表达时另起一段。总占用超过预算时丢弃最旧的段，内存只取决于预算，与对局长度无关。
+// 恢复某一帧时从所在段的关键帧顺序应用增量，最多 KEYFRAME_INTERVAL 步。
+class RewindBuffer {
+public:
+    static constexpr std::uint32_t KEYFRAME_INTERVAL = 64;  // 每段最多的增量帧数
+
+    explicit RewindBuffer(std::size_t budgetBytes);
+
+    bool isEnabled() const { return budgetBytes > 0; }
+    void clear();
+    bool needsKeyframe(const RewindFrame& frame) const;  // 该帧无法写成相对上一帧的增量时返回 true
+    void addKeyframe(const GameState& state, const RewindFrame& frame);
+    void addDelta(const RewindFrame& frame);
+
+    bool empty() const { return segments.empty(); }
+    std::uint64_t getOldestTick() const;
+    std::uint64_t getNewestTick() const { return last.tick; }
+    std::size_t getMemoryUsed() const { return memoryUsed; }
+    bool stateAt(std::uint64_t tick, GameState& state) const;  // 组装该帧的完整局面（不含自动寻路路径），不在缓冲区内时返回 false
+    void truncateAfter(std::uint64_t tick);                     // 丢弃该帧之后的历史，之后从该帧继续记录
+
+private:
+    struct Segment {
+        GameState keyframe;                 // 蛇身能打包时 body 为空，存在 packedBody 中
+        PackedBody packedBody;
+        RewindFrame keyFrame;               // 关键帧对应的逐帧字段，增量相对它解码
+        std::vector<unsigned char> deltas;
+        std::uint32_t count = 0;            // 增量帧数
+        std::size_t bytes = 0;              // 计入预算的占用
+    };
+
+    std::size_t budgetBytes;
+    std::deque<Segment> segments;
+    RewindFrame last;                       // 最近记录的一帧，下一帧的增量相对它编码
+    std::size_t memoryUsed;
+
+    static std::size_t keyframeBytes(const Segment& segment);
+    static void encode(const RewindFrame& previous, const RewindFrame& frame, std::vector<unsigned char>& out);
+    static std::size_t decode(const unsigned char* data, const RewindFrame& previous, RewindFrame& frame);  // 返回读取的字节数
+    void evict();
+};
+
+#endif // REWINDBUFFER_H
@@ -0,0 +1,433 @@
+#include "SaveFile.h"
+#include "Board.h"
+#include "MappedFile.h"
+#include "PackedBody.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+const char MAGIC[4] = {'S', 'N', 'K', 'S'};
+const char AUTOSAVE_MAGIC[4] = {'S', 'N', 'K', 'A'};
+constexpr std::size_t HEADER_SIZE = 4 + 2 + 2 + 8 + 8;  // 魔数、版本、保留、负载长度、校验和
+constexpr std::size_t STATE_FIELDS_SIZE = 2 + 2 + 8 + 4 + 4 + 8 * 3 + 8 * 4 + 2 + 2;  // 蛇身、障碍物、路径之外的定长字段
+constexpr std::size_t FIXED_PAYLOAD_SIZE = STATE_FIELDS_SIZE + 4 + 4 + 13;  // 定长字段、计数和紧凑蛇身的头部
+constexpr std::size_t AUTOSAVE_PREFIX_SIZE = 8 + 1;  // 序号、类型
+
+enum class AutosaveKind : std::uint8_t {
+    FULL,
+    DELTA
+};
+
+void putInt(std::vector<char>& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void setInt(std::vector<char>& out, std::size_t pos, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[pos + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+std::uint64_t loadInt(const unsigned char* p, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// 按 8 字节字做 FNV-1a 式混合，比逐字节快，能发现截断和位翻转
+std::uint64_t checksum(const unsigned char* data, std::size_t size) {
+    const std::uint64_t PRIME = 0x100000001B3ULL;
+    std::uint64_t hash = 0xCBF29CE484222325ULL ^ size;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        hash = (hash ^ loadInt(data + i, 8)) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * PRIME;
+    }
+    return hash ^ (hash >> 32);
+}
+
+class Reader {
+public:
+    Reader(const unsigned char* data, std::size_t size) : data(data), size(size), pos(0), ok(true) {}
+
+    std::uint64_t getInt(int bytes) {
+        if (pos + bytes > size) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = loadInt(data + pos, bytes);
+        pos += bytes;
+        return value;
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == size; }
+    std::size_t remaining() const { return size - pos; }
+
+private:
+    const unsigned char* data;
+    std::size_t size;
+    std::size_t pos;
+    bool ok;
+};
+
+void putCells(std::vector<char>& out, const std::vector<std::pair<int, int>>& cells) {
+    for (const auto& cell : cells) {
+        putInt(out, static_cast<std::uint16_t>(cell.first), 2);
+        putInt(out, static_cast<std::uint16_t>(cell.second), 2);
+    }
+}
+
+// 坐标按 16 位有符号数读取：撞墙结束的对局蛇头在棋盘外一格，写入时 -1 存为 0xFFFF
+int getCoordinate(Reader& in) {
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(in.getInt(2)));
+}
+
+// 格子须在棋盘内；蛇头（mayLeave）可以在棋盘外一圈，是否合理由 Game 按对局结果判断
+bool cellAllowed(const std::pair<int, int>& cell, int width, int height, bool mayLeave) {
+    int margin = mayLeave ? 1 : 0;
+    return cell.first >= -margin && cell.first < width + margin && cell.second >= -margin && cell.second < height + margin;
+}
+
+bool getCells(Reader& in, std::uint64_t count, int width, int height, std::vector<std::pair<int, int>>& cells,
+              bool headMayLeave = false) {
+    // 先按剩余字节数检查数量，避免损坏的计数导致巨量分配
+    if (count > in.remaining() / 4) return false;
+    cells.resize(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        cells[i].first = getCoordinate(in);
+        cells[i].second = getCoordinate(in);
+        if (!cellAllowed(cells[i], width, height, headMayLeave && i == 0)) return false;
+    }
+    return in.good();
+}
+
+void beginFile(std::vector<char>& out, const char* magic, std::size_t payloadHint) {
+    out.clear();
+    out.reserve(HEADER_SIZE + payloadHint);
+    out.insert(out.end(), magic, magic + 4);
+    putInt(out, SaveFile::FORMAT_VERSION, 2);
+    putInt(out, 0, 2);
+    putInt(out, 0, 8);  // 负载长度，写完后回填
+    putInt(out, 0, 8);  // 校验和，写完后回填
+}
+
+void finishFile(std::vector<char>& out) {
+    std::size_t payloadSize = out.size() - HEADER_SIZE;
+    setInt(out, 8, payloadSize, 8);
+    setInt(out, 16, checksum(reinterpret_cast<const unsigned char*>(out.data()) + HEADER_SIZE, payloadSize), 8);
+}
+
+// 校验文件头和校验和，成功时返回负载的位置、长度和格式版本
+bool openPayload(const unsigned char* data, std::size_t size, const char* magic,
+                 const unsigned char*& payload, std::size_t& payloadSize, std::uint16_t& version) {
+    if (size < HEADER_SIZE || std::memcmp(data, magic, 4) != 0) return false;
+    version = static_cast<std::uint16_t>(loadInt(data + 4, 2));
+    if (version < 1 || version > SaveFile::FORMAT_VERSION) return false;
+    std::uint64_t declared = loadInt(data + 8, 8);
+    if (declared != size - HEADER_SIZE) return false;
+    payload = data + HEADER_SIZE;
+    payloadSize = static_cast<std::size_t>(declared);
+    return checksum(payload, payloadSize) == loadInt(data + 16, 8);
+}
+
+void putStateFields(std::vector<char>& out, const GameState& state) {
+    putInt(out, static_cast<std::uint64_t>(state.width), 2);
+    putInt(out, static_cast<std::uint64_t>(state.height), 2);
+    putInt(out, state.difficulty, 1);
+    putInt(out, state.initialDifficulty, 1);
+    putInt(out, state.direction, 1);
+    putInt(out, state.outcome, 1);
+    putInt(out, state.foodType, 1);
+    putInt(out, (state.paused ? 1 : 0) | (state.autoPathEnabled ? 2 : 0) | (state.alwaysAutoPath ? 4 : 0), 1);
+    putInt(out, 0, 2);
+    putInt(out, static_cast<std::uint32_t>(state.score), 4);
+    putInt(out, static_cast<std::uint32_t>(state.highScore), 4);
+    putInt(out, state.tickCount, 8);
+    putInt(out, state.autoPathStartTick, 8);
+    putInt(out, state.seed, 8);
+    for (std::uint64_t word : state.rng.s) {
+        putInt(out, word, 8);
+    }
+    putInt(out, static_cast<std::uint16_t>(state.food.first), 2);
+    putInt(out, static_cast<std::uint16_t>(state.food.second), 2);
+}
+
+bool getStateFields(Reader& in, GameState& loaded) {
+    loaded.width = static_cast<int>(in.getInt(2));
+    loaded.height = static_cast<int>(in.getInt(2));
+    loaded.difficulty = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.initialDifficulty = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.direction = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.outcome = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.foodType = static_cast<std::uint8_t>(in.getInt(1));
+    std::uint8_t flags = static_cast<std::uint8_t>(in.getInt(1));
+    loaded.paused = (flags & 1) != 0;
+    loaded.autoPathEnabled = (flags & 2) != 0;
+    loaded.alwaysAutoPath = (flags & 4) != 0;
+    in.getInt(2);
+    loaded.score = static_cast<std::int32_t>(static_cast<std::uint32_t>(in.getInt(4)));
+    loaded.highScore = static_cast<std::int32_t>(static_cast<std::uint32_t>(in.getInt(4)));
+    loaded.tickCount = in.getInt(8);
+    loaded.autoPathStartTick = in.getInt(8);
+    loaded.seed = in.getInt(8);
+    for (std::uint64_t& word : loaded.rng.s) {
+        word = in.getInt(8);
+    }
+    loaded.food.first = static_cast<int>(in.getInt(2));
+    loaded.food.second = static_cast<int>(in.getInt(2));
+    return in.good() && loaded.width == BoardSize::clampSide(loaded.width) &&
+           loaded.height == BoardSize::clampSide(loaded.height);
+}
+
+void putPath(std::vector<char>& out, const std::vector<std::uint8_t>& path) {
+    out.insert(out.end(), path.begin(), path.end());
+}
+
+bool getPath(Reader& in, std::uint64_t length, std::vector<std::uint8_t>& path) {
+    if (length > in.remaining()) return false;
+    path.resize(static_cast<std::size_t>(length));
+    for (auto& dir : path) {
+        dir = static_cast<std::uint8_t>(in.getInt(1));
+    }
+    return in.good();
+}
+
+// 蛇身（版本 2 起）：类型 1 为紧凑方向链（蛇头、节数、蛇尾重叠节数、每节 2 位），
+// 类型 0 为坐标数组，只在蛇身不是相邻格子组成的链时使用
+void putBody(std::vector<char>& out, const std::vector<std::pair<int, int>>& body) {
+    PackedBody packed;
+    if (packed.pack(body)) {
+        putInt(out, 1, 1);
+        putInt(out, static_cast<std::uint16_t>(packed.front().first), 2);
+        putInt(out, static_cast<std::uint16_t>(packed.front().second), 2);
+        putInt(out, packed.size(), 4);
+        putInt(out, packed.getTailRepeat(), 4);
+        out.insert(out.end(), packed.getBits().begin(), packed.getBits().end());
+    } else {
+        putInt(out, 0, 1);
+        putInt(out, body.size(), 4);
+        putCells(out, body);
+    }
+}
+
+bool getBody(Reader& in, int width, int height, std::vector<std::pair<int, int>>& body) {
+    std::uint64_t kind = in.getInt(1);
+    if (kind == 0) {
+        return getCells(in, in.getInt(4), width, height, body, true);
+    }
+    if (kind != 1) return false;
+
+    std::pair<int, int> head;
+    head.first = getCoordinate(in);
+    head.second = getCoordinate(in);
+    std::uint64_t length = in.getInt(4);
+    std::uint64_t tailRepeat = in.getInt(4);
+    if (!in.good() || length == 0 || tailRepeat >= length || length > 0xFFFFFFFFu) return false;
+    std::uint64_t byteCount = (length - 1 - tailRepeat + 3) / 4;
+    if (byteCount > in.remaining()) return false;
+    std::vector<std::uint8_t> bits(static_cast<std::size_t>(byteCount));
+    for (auto& byte : bits) {
+        byte = static_cast<std::uint8_t>(in.getInt(1));
+    }
+    PackedBody packed;
+    if (!packed.assign(head, static_cast<std::uint32_t>(length), static_cast<std::uint32_t>(tailRepeat),
+                       bits.data(), bits.size())) {
+        return false;
+    }
+    // 方向链可能走出棋盘，解包前逐节检查
+    bool inside = true;
+    bool first = true;
+    packed.forEach([&](const std::pair<int, int>& cell) {
+        inside = inside && cellAllowed(cell, width, height, first);
+        first = false;
+    });
+    if (!inside) return false;
+    packed.unpack(body);
+    return true;
+}
+
+// 版本 1 的蛇身是紧跟在计数后的坐标数组，版本 2 改为 putBody 的编码
+void putFullState(std::vector<char>& out, const GameState& state) {
+    putStateFields(out, state);
+    putInt(out, state.obstacles.size(), 4);
+    putInt(out, state.path.size(), 4);
+    putBody(out, state.body);
+    putCells(out, state.obstacles);
+    putPath(out, state.path);
+}
+
+bool getFullState(Reader& in, std::uint16_t version, GameState& loaded) {
+    if (!getStateFields(in, loaded)) return false;
+    std::uint64_t bodySize = version == 1 ? in.getInt(4) : 0;
+    std::uint64_t obstacleCount = in.getInt(4);
+    std::uint64_t pathLength = in.getInt(4);
+    if (!in.good()) return false;
+    if (version == 1) {
+        if (bodySize == 0 || !getCells(in, bodySize, loaded.width, loaded.height, loaded.body, true)) return false;
+    } else if (!getBody(in, loaded.width, loaded.height, loaded.body) || loaded.body.empty()) {
+        return false;
+    }
+    if (!getCells(in, obstacleCount, loaded.width, loaded.height, loaded.obstacles)) return false;
+    return pathLength == in.remaining() && getPath(in, pathLength, loaded.path);
+}
+
+// 蛇身相对 base 的变化：state.body = 新增的 prefix 格 + base.body 的前 kept 格。
+// 几十帧内蛇只是往前走并可能变长，这样只需记录新蛇头走过的格子；对不上时返回 false，改存完整蛇身
+bool matchBody(const GameState& base, const GameState& state, std::size_t& prefix) {
+    if (base.body.empty()) return false;
+    for (prefix = 0; prefix < state.body.size(); ++prefix) {
+        std::size_t kept = state.body.size() - prefix;
+        if (kept > base.body.size() || state.body[prefix] != base.body.front()) continue;
+        if (std::equal(state.body.begin() + static_cast<std::ptrdiff_t>(prefix), state.body.end(), base.body.begin())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 增量负载：定长字段；蛇身（标志 1 为 prefix 格加保留长度，0 为完整蛇身）；障碍物（标志 0 表示与 base 相同）；路径
+void putDeltaState(std::vector<char>& out, const GameState& base, const GameState& state) {
+    putStateFields(out, state);
+    std::size_t prefix = 0;
+    if (matchBody(base, state, prefix)) {
+        putInt(out, 1, 1);
+        putInt(out, prefix, 4);
+        putInt(out, state.body.size() - prefix, 4);
+        for (std::size_t i = 0; i < prefix; ++i) {
+            putInt(out, static_cast<std::uint16_t>(state.body[i].first), 2);
+            putInt(out, static_cast<std::uint16_t>(state.body[i].second), 2);
+        }
+    } else {
+        putInt(out, 0, 1);
+        putBody(out, state.body);
+    }
+    if (state.obstacles == base.obstacles) {
+        putInt(out, 0, 1);
+    } else {
+        putInt(out, 1, 1);
+        putInt(out, state.obstacles.size(), 4);
+        putCells(out, state.obstacles);
+    }
+    putInt(out, state.path.size(), 4);
+    putPath(out, state.path);
+}
+
+bool getDeltaState(Reader& in, std::uint16_t version, const GameState& base, GameState& loaded) {
+    if (!getStateFields(in, loaded)) return false;
+    if (loaded.width != base.width || loaded.height != base.height) return false;
+
+    std::uint64_t bodyKind = in.getInt(1);
+    if (bodyKind == 1) {
+        std::uint64_t prefix = in.getInt(4);
+        std::uint64_t kept = in.getInt(4);
+        if (!in.good() || kept > base.body.size()) return false;
+        if (!getCells(in, prefix, loaded.width, loaded.height, loaded.body, true)) return false;
+        loaded.body.insert(loaded.body.end(), base.body.begin(), base.body.begin() + static_cast<std::ptrdiff_t>(kept));
+    } else if (bodyKind == 0) {
+        bool ok = version == 1 ? getCells(in, in.getInt(4), loaded.width, loaded.height, loaded.body, true)
+                               : getBody(in, loaded.width, loaded.height, loaded.body);
+        if (!ok) return false;
+    } else {
+        return false;
+    }
+    if (loaded.body.empty()) return false;
+
+    std::uint64_t obstacleKind = in.getInt(1);
+    if (obstacleKind == 0) {
+        loaded.obstacles = base.obstacles;
+    } else if (obstacleKind != 1 || !getCells(in, in.getInt(4), loaded.width, loaded.height, loaded.obstacles)) {
+        return false;
+    }
+
+    std::uint64_t pathLength = in.getInt(4);
+    return in.good() && pathLength == in.remaining() && getPath(in, pathLength, loaded.path);
+}
+
+} // namespace
+
+namespace SaveFile {
+
+bool write(const std::string& filename, const GameState& state) {
+    std::vector<char> out;
+    beginFile(out, MAGIC, FIXED_PAYLOAD_SIZE + state.body.size() / 4 + state.obstacles.size() * 4 + state.path.size());
+    putFullState(out, state);
+    finishFile(out);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+bool read(const std::string& filename, GameState& state) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    const unsigned char* payload = nullptr;
+    std::size_t payloadSize = 0;
+    std::uint16_t version = 0;
+    if (!openPayload(file.data(), file.size(), MAGIC, payload, payloadSize, version)) return false;
+
+    Reader in(payload, payloadSize);
+    GameState loaded;
+    if (!getFullState(in, version, loaded)) return false;
+    state = std::move(loaded);
+    return true;
+}
+
+void encodeAutosave(std::uint64_t sequence, const GameState* base, const GameState& state, std::vector<char>& out) {
+    beginFile(out, AUTOSAVE_MAGIC, AUTOSAVE_PREFIX_SIZE + FIXED_PAYLOAD_SIZE + 2 +
+              state.body.size() / 4 + state.obstacles.size() * 4 + state.path.size());
+    putInt(out, sequence, 8);
+    if (base != nullptr) {
+        putInt(out, static_cast<std::uint8_t>(AutosaveKind::DELTA), 1);
+        putDeltaState(out, *base, state);
+    } else {
+        putInt(out, static_cast<std::uint8_t>(AutosaveKind::FULL), 1);
+        putFullState(out, state);
+    }
+    finishFile(out);
+}
+
+bool readAutosave(const std::string& filename, AutosaveImage& image) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    const unsigned char* payload = nullptr;
+    std::size_t payloadSize = 0;
+    std::uint16_t version = 0;
+    if (!openPayload(file.data(), file.size(), AUTOSAVE_MAGIC, payload, payloadSize, version)) return false;
+    if (payloadSize < AUTOSAVE_PREFIX_SIZE) return false;
+    std::uint8_t kind = payload[8];
+    if (kind > static_cast<std::uint8_t>(AutosaveKind::DELTA)) return false;
+
+    image.version = version;
+    image.sequence = loadInt(payload, 8);
+    image.delta = kind == static_cast<std::uint8_t>(AutosaveKind::DELTA);
+    image.payload.assign(payload + AUTOSAVE_PREFIX_SIZE, payload + payloadSize);
+    return true;
+}
+
+bool decodeAutosave(const AutosaveImage& image, const GameState* base, GameState& state) {
+    if (image.delta && base == nullptr) return false;
+    Reader in(image.payload.data(), image.payload.size());
+    GameState loaded;
+    if (image.delta ? !getDeltaState(in, image.version, *base, loaded) : !getFullState(in, image.version, loaded)) {
+        return false;
+    }
+    state = std::move(loaded);
+    return true;
+}
+
+} // namespace SaveFile
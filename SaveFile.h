@@ -0,0 +1,34 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include "GameState.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 存档文件：固定文件头（魔数、版本、负载长度、校验和）加小端序负载。
+// 写入时先在内存中拼好整个文件再一次写出；读取时映射文件，校验后直接从映射内存解码。
+namespace SaveFile {
+
+// 版本 2：蛇身改为紧凑方向链（见 PackedBody），仍可读取版本 1
+constexpr std::uint16_t FORMAT_VERSION = 2;
+
+bool write(const std::string& filename, const GameState& state);
+bool read(const std::string& filename, GameState& state);  // 文件损坏、版本不符或数据越界时返回 false，state 不变
+
+// 自动存档：文件头与普通存档相同（魔数不同），负载开头是序号和类型。
+// 完整存档记录整个局面；增量存档只记录相对序号为 sequence - 1 的存档的变化，读取时要先恢复出前一个局面。
+struct AutosaveImage {
+    std::uint16_t version = 0;
+    std::uint64_t sequence = 0;
+    bool delta = false;
+    std::vector<unsigned char> payload;  // 已通过校验的负载（不含序号和类型）
+};
+
+void encodeAutosave(std::uint64_t sequence, const GameState* base, const GameState& state, std::vector<char>& out);  // base 为空时写完整存档
+bool readAutosave(const std::string& filename, AutosaveImage& image);  // 只校验文件，不解码局面
+bool decodeAutosave(const AutosaveImage& image, const GameState* base, GameState& state);  // 增量存档需要前一个局面作为 base
+
+} // namespace SaveFile
+
+#endif // SAVEFILE_H
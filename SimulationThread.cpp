@@ -0,0 +1,220 @@
+#include "SimulationThread.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+SimulationThread::SimulationThread(const GameConfig& config, Leaderboard* leaderboard, AutosaveManager* autosave)
+    : generation(0), leaderboard(leaderboard), resultRecorded(false), autosave(autosave), lastAutosaveTick(0),
+      stopping(false), publishRequested(false),
+      lastTickNs(steadyClockNs()), tickJitterMs(0.0), catchUpTicks(0) {
+    game.reset(createGame(config));
+    // 先发布开局画面，界面线程构造完成后即可绘制
+    publish(lastTickNs);
+    worker = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread() {
+    stopping.store(true);
+    wake();
+    worker.join();
+    // 中途退出的对局也计入排行榜
+    recordResult();
+}
+
+bool SimulationThread::post(const SimulationCommand& command) {
+    if (!commands.push(command)) return false;
+    wake();
+    return true;
+}
+
+bool SimulationThread::acquireSnapshot() {
+    return snapshots.acquire();
+}
+
+void SimulationThread::reset(const GameConfig& config) {
+    {
+        // 旧对局在锁内析构，保证与模拟线程的推进互斥
+        std::lock_guard<std::mutex> lock(gameMutex);
+        recordResult();
+        game.reset(createGame(config));
+        resultRecorded = false;
+        lastAutosaveTick = 0;
+        if (autosave != nullptr) autosave->restart();
+        ++generation;
+    }
+    requestPublish();
+}
+
+void SimulationThread::requestPublish() {
+    publishRequested.store(true);
+    wake();
+}
+
+void SimulationThread::wake() {
+    // 空的临界区保证模拟线程要么还没检查等待条件，要么已经在等待，不会丢失唤醒
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wakeCondition.notify_one();
+}
+
+void SimulationThread::run() {
+    std::uint64_t lastFrameNs = steadyClockNs();
+    std::uint64_t accumulatorNs = 0;
+    bool idle = false;
+
+    while (!stopping.load()) {
+        std::uint64_t dueNs;
+        {
+            std::lock_guard<std::mutex> lock(gameMutex);
+            bool changed = publishRequested.exchange(false);
+
+            SimulationCommand command;
+            while (commands.pop(command)) {
+                applyCommand(command);
+                changed = true;
+            }
+
+            std::uint64_t now = steadyClockNs();
+            std::uint64_t elapsed = now - lastFrameNs;
+            lastFrameNs = now;
+            idle = game->isPaused() || game->isGameOver();
+            if (idle) {
+                // 暂停期间不累积时间，恢复后从当前时刻重新计时
+                accumulatorNs = 0;
+                lastTickNs = now;
+            } else {
+                // 逻辑帧按固定步长从累加器中扣除，唤醒误差不会累积成漂移
+                // 一次唤醒补跑的多帧共用同一时刻，只有第一帧计入间隔抖动，其余单独计数
+                accumulatorNs = std::min(accumulatorNs + elapsed, MAX_CATCH_UP_TICKS * TICK_INTERVAL_NS);
+                bool catchingUp = false;
+                while (accumulatorNs >= TICK_INTERVAL_NS && !game->isGameOver()) {
+                    accumulatorNs -= TICK_INTERVAL_NS;
+                    game->update();
+                    if (catchingUp) {
+                        ++catchUpTicks;
+                    } else {
+                        recordTick(now);
+                        catchingUp = true;
+                    }
+                    changed = true;
+                }
+            }
+
+            // 对局结束时提交成绩；读档换成进行中的对局后重新允许提交
+            if (game->isGameOver()) {
+                recordResult();
+            } else {
+                resultRecorded = false;
+                autosaveIfDue();
+            }
+
+            // 跨越多帧时只发布最后一帧，中间的画面界面线程也来不及显示
+            if (changed) {
+                publish(now - accumulatorNs);
+            }
+            dueNs = now + (TICK_INTERVAL_NS - accumulatorNs);
+        }
+
+        // 睡到下一帧到期，或者有新输入、画面请求、停止请求为止
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        auto ready = [&] { return stopping.load() || publishRequested.load() || !commands.empty(); };
+        if (idle) {
+            wakeCondition.wait(lock, ready);
+        } else {
+            std::uint64_t now = steadyClockNs();
+            if (dueNs > now) {
+                wakeCondition.wait_for(lock, std::chrono::nanoseconds(dueNs - now), ready);
+            }
+        }
+    }
+}
+
+Game* SimulationThread::createGame(const GameConfig& config) const {
+    if (leaderboard == nullptr) return new Game(config);
+    GameConfig withBest = config;
+    withBest.highScore = std::max(config.highScore, leaderboard->getBestScore());
+    return new Game(withBest);
+}
+
+void SimulationThread::recordResult() {
+    if (leaderboard != nullptr && !resultRecorded && game->getScore() > 0 && game->isRankable()) {
+        LeaderboardEntry entry;
+        entry.score = game->getScore();
+        entry.length = static_cast<int>(game->getSnake().getBody().size());
+        entry.difficulty = static_cast<std::uint8_t>(game->getInitialDifficulty());
+        entry.durationTicks = game->getTickCount();
+        entry.seed = game->getSeed();
+        leaderboard->submit(entry);
+    }
+    resultRecorded = true;
+}
+
+void SimulationThread::autosaveIfDue() {
+    if (autosave == nullptr) return;
+    std::uint64_t tick = game->getTickCount();
+    // 读档后帧数可能倒退，此时按新的帧数重新计时
+    if (tick < lastAutosaveTick) lastAutosaveTick = tick;
+    if (tick - lastAutosaveTick < static_cast<std::uint64_t>(Game::AUTOSAVE_INTERVAL_TICKS)) return;
+    lastAutosaveTick = tick;
+    game->captureState(autosaveState);
+    autosave->submit(autosaveState);
+}
+
+void SimulationThread::applyCommand(const SimulationCommand& command) {
+    switch (command.kind) {
+        case SimulationCommand::Kind::DIRECTION:
+            game->submitDirection(static_cast<Direction>(command.value), command.arrivalNs);
+            break;
+        case SimulationCommand::Kind::TOGGLE_PAUSE:
+            game->togglePause();
+            break;
+        case SimulationCommand::Kind::DIFFICULTY:
+            game->setDifficulty(static_cast<Game::Difficulty>(command.value));
+            break;
+        case SimulationCommand::Kind::REWIND:
+            // 回退后帧数倒退，按替换对局处理，界面整体重绘并重新允许弹出结束提示
+            if (game->rewind(static_cast<std::uint64_t>(command.value) * 1000 / Game::TICK_INTERVAL_MS)) {
+                ++generation;
+            }
+            break;
+    }
+}
+
+void SimulationThread::recordTick(std::uint64_t now) {
+    double deviationMs = std::abs(static_cast<double>(now - lastTickNs) - static_cast<double>(TICK_INTERVAL_NS)) / 1e6;
+    tickJitterMs += (deviationMs - tickJitterMs) / 16;
+    lastTickNs = now;
+}
+
+void SimulationThread::publish(std::uint64_t tickTimeNs) {
+    // 写端槽位里是两次发布之前的旧数据，逐项覆盖；vector 复用已有容量，稳定后不再分配内存
+    GameSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.generation = generation;
+    snapshot.tick = game->getTickCount();
+    snapshot.tickTimeNs = tickTimeNs;
+    snapshot.width = game->getWidth();
+    snapshot.height = game->getHeight();
+    snapshot.body.pack(game->getSnake());
+    snapshot.food = game->getFood().getPosition();
+    snapshot.specialFood = game->getFood().isSpecial();
+    snapshot.obstacles.assign(game->getObstacles().begin(), game->getObstacles().end());
+    snapshot.obstacleHash = game->getObstacleHash();
+    snapshot.score = game->getScore();
+    snapshot.highScore = game->getHighScore();
+    snapshot.difficulty = game->getDifficulty();
+    snapshot.outcome = game->getOutcome();
+    snapshot.paused = game->isPaused();
+    snapshot.autoPathActive = game->isAutoPathActive();
+    snapshot.autoPathRemainingSeconds = game->getAutoPathRemainingSeconds();
+    snapshot.tickJitterMs = tickJitterMs;
+    snapshot.catchUpTicks = catchUpTicks;
+    const LatencyHistogram& latency = game->getInputLatency();
+    snapshot.inputCount = latency.getCount();
+    snapshot.inputP50Ns = latency.percentile(0.5);
+    snapshot.inputP99Ns = latency.percentile(0.99);
+    const LatencyHistogram& planning = game->getPlanLatency();
+    snapshot.planCount = planning.getCount();
+    snapshot.planP50Ns = planning.percentile(0.5);
+    snapshot.planP99Ns = planning.percentile(0.99);
+    snapshot.latePlans = game->getLatePlans();
+    snapshots.publish();
+}
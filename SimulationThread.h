@@ -0,0 +1,128 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include "game.h"
+#include "AutosaveManager.h"
+#include "Leaderboard.h"
+#include "PackedBody.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 某一逻辑帧的只读画面数据，由模拟线程发布给界面线程
+struct GameSnapshot {
+    std::uint64_t generation = 0;      // 对局被整体替换（新对局、读档等）时递增
+    std::uint64_t tick = 0;
+    std::uint64_t tickTimeNs = 0;      // 该帧按固定步长应当执行的时刻（steadyClockNs）
+    int width = 0;
+    int height = 0;
+    PackedBody body;                   // 从头到尾，方向链形式，发布时不复制坐标数组
+    std::pair<int, int> food;
+    bool specialFood = false;
+    std::vector<std::pair<int, int>> obstacles;
+    std::uint64_t obstacleHash = 0;
+    int score = 0;
+    int highScore = 0;
+    Game::Difficulty difficulty = Game::Difficulty::NORMAL;
+    Game::Outcome outcome = Game::Outcome::PLAYING;
+    bool paused = false;
+    bool autoPathActive = false;
+    int autoPathRemainingSeconds = 0;
+    double tickJitterMs = 0.0;         // 逻辑帧实际间隔与标称间隔之差的滑动平均（毫秒），不含补跑的帧
+    std::uint64_t catchUpTicks = 0;    // 落后时同一次唤醒中补跑的帧数
+    std::uint64_t inputCount = 0;      // 已应用的输入数
+    std::uint64_t inputP50Ns = 0;      // 输入延迟中位数
+    std::uint64_t inputP99Ns = 0;
+    std::uint64_t planCount = 0;       // 自动寻路搜索次数
+    std::uint64_t planP50Ns = 0;       // 单次搜索耗时中位数
+    std::uint64_t planP99Ns = 0;
+    std::uint64_t latePlans = 0;       // 后台规划未及时完成的次数
+};
+
+// 界面线程发给模拟线程的输入
+struct SimulationCommand {
+    enum class Kind : std::uint8_t {
+        DIRECTION,     // value 为 Direction
+        TOGGLE_PAUSE,
+        DIFFICULTY,    // value 为 Game::Difficulty
+        REWIND         // value 为回退的秒数
+    };
+
+    Kind kind;
+    std::uint8_t value;
+    std::uint64_t arrivalNs;  // 按键时刻（steadyClockNs）
+};
+
+// 在独立线程上按固定步长推进对局。
+// 每次推进后把画面数据写入无锁三缓冲，界面线程随时取最新的一份绘制；
+// 输入经无锁 SPSC 队列送到模拟线程，在下一次唤醒时应用。
+class SimulationThread {
+public:
+    static constexpr std::uint64_t TICK_INTERVAL_NS = static_cast<std::uint64_t>(Game::TICK_INTERVAL_MS) * 1000000;
+    static constexpr int MAX_CATCH_UP_TICKS = 5;  // 单次唤醒最多补跑的逻辑帧数，超出部分丢弃
+    static constexpr std::size_t COMMAND_CAPACITY = 64;
+
+    // leaderboard 可为空，对局结束时把成绩提交给它；autosave 可为空，进行中的对局每 AUTOSAVE_INTERVAL_TICKS 帧交给它存档
+    explicit SimulationThread(const GameConfig& config, Leaderboard* leaderboard = nullptr, AutosaveManager* autosave = nullptr);
+    ~SimulationThread();
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // 以下只能在界面线程调用
+    bool post(const SimulationCommand& command);  // 队列满时返回 false
+    bool acquireSnapshot();                       // 有新画面时返回 true
+    const GameSnapshot& getSnapshot() const { return snapshots.readBuffer(); }
+    void reset(const GameConfig& config);         // 开始新对局
+
+    // 在模拟线程两帧之间独占访问对局（存档、读档、导出录像等低频操作），之后重新发布画面
+    template<typename F>
+    auto withGame(F&& f) -> decltype(f(std::declval<Game&>())) {
+        struct Republish {
+            SimulationThread* owner;
+            ~Republish() { owner->requestPublish(); }
+        } republish{this};
+        std::lock_guard<std::mutex> lock(gameMutex);
+        ++generation;
+        return f(*game);
+    }
+
+private:
+    std::unique_ptr<Game> game;
+    std::mutex gameMutex;         // 模拟线程推进对局时持有
+    std::uint64_t generation;     // 受 gameMutex 保护
+    Leaderboard* leaderboard;
+    bool resultRecorded;          // 当前对局的成绩是否已提交，受 gameMutex 保护
+    AutosaveManager* autosave;
+    GameState autosaveState;      // 交给自动存档的局面，与存档线程交换缓冲区，只由持有 gameMutex 的线程访问
+    std::uint64_t lastAutosaveTick;
+    SpscQueue<SimulationCommand, COMMAND_CAPACITY> commands;
+    TripleBuffer<GameSnapshot> snapshots;
+
+    std::mutex wakeMutex;         // 只用于休眠和唤醒，不保护数据
+    std::condition_variable wakeCondition;
+    std::atomic<bool> stopping;
+    std::atomic<bool> publishRequested;
+    std::uint64_t lastTickNs;     // 以下只由模拟线程访问
+    double tickJitterMs;
+    std::uint64_t catchUpTicks;
+    std::thread worker;
+
+    void run();
+    Game* createGame(const GameConfig& config) const;  // 最高分取配置与排行榜中较大的一个
+    void recordResult();                               // 提交当前对局的成绩（只改排行榜内存，不等待写盘），回退过的对局不提交
+    void autosaveIfDue();                              // 到了存档间隔时复制一份局面交给自动存档
+    void applyCommand(const SimulationCommand& command);
+    void recordTick(std::uint64_t now);
+    void publish(std::uint64_t tickTimeNs);
+    void requestPublish();
+    void wake();
+};
+
+#endif // SIMULATIONTHREAD_H
@@ -1,18 +1,47 @@
 #include "Snake.h"
+#include "Zobrist.h"
 #include <algorithm>
 
-Snake::Snake(int startX, int startY) : direction(Direction::RIGHT), isAlive(true) {
+namespace {
+const std::size_t INITIAL_CAPACITY = 16;  // 环形缓冲区初始容量（2 的幂）
+
+// 蛇身哈希的底数取奇数，模 2^64 下可逆，蛇尾移出时乘以逆元即可
+constexpr std::uint64_t ORDER_BASE = 0x9E3779B97F4A7C15ULL;
+
+constexpr std::uint64_t inverse(std::uint64_t a) {
+    std::uint64_t x = a;  // 牛顿迭代，每次有效位数翻倍，奇数 a 的初值已有 3 位
+    for (int i = 0; i < 5; ++i) {
+        x *= 2 - a * x;
+    }
+    return x;
+}
+
+constexpr std::uint64_t ORDER_BASE_INVERSE = inverse(ORDER_BASE);
+static_assert(ORDER_BASE * ORDER_BASE_INVERSE == 1, "蛇身哈希底数的逆元");
+
+std::uint64_t segmentKey(const Snake::Segment& segment) {
+    return Zobrist::key(Zobrist::Feature::BODY,
+                        (static_cast<std::uint64_t>(static_cast<std::uint32_t>(segment.first)) << 32) |
+                        static_cast<std::uint32_t>(segment.second));
+}
+}
+
+Snake::Snake(int startX, int startY, int boardWidth, int boardHeight)
+    : ring(INITIAL_CAPACITY), headIndex(0), length(0),
+      occupancy(static_cast<std::size_t>(boardWidth) * boardHeight, 0), bodyHash(0), bodyPower(1),
+      boardWidth(boardWidth), boardHeight(boardHeight),
+      direction(Direction::RIGHT), isAlive(true) {
     // 初始化蛇身，长度为3
-    body.push_back({startX, startY});
-    body.push_back({startX - 1, startY});
-    body.push_back({startX - 2, startY});
+    pushBack({startX, startY});
+    pushBack({startX - 1, startY});
+    pushBack({startX - 2, startY});
 }
 
 void Snake::move() {
     if (!isAlive) return;
 
     // 获取头部位置
-    auto head = body.front();
+    auto head = segmentAt(0);
     
     // 根据方向移动头部
     switch (direction) {
@@ -30,35 +59,28 @@ void Snake::move() {
             break;
     }
     
-    // 在头部添加新的位置
-    body.push_front(head);
-    // 移除尾部
-    body.pop_back();
+    // 先移除尾部再添加头部，缓冲区不会扩容
+    popBack();
+    pushFront(head);
 }
 
 void Snake::grow() {
     // 复制尾部位置
-    auto tail = body.back();
+    auto tail = segmentAt(length - 1);
     // 在尾部添加新的位置
-    body.push_back(tail);
+    pushBack(tail);
 }
 
 bool Snake::checkCollision(int width, int height) const {
-    auto head = body.front();
+    auto head = segmentAt(0);
     return head.first < 0 || head.first >= width || 
            head.second < 0 || head.second >= height;
 }
 
 bool Snake::isCollidingWithSelf() const {
-    auto head = body.front();
-    auto it = body.begin();
-    ++it;  // 跳过头部
-    for (; it != body.end(); ++it) {
-        if (it->first == head.first && it->second == head.second) {
-            return true;
-        }
-    }
-    return false;
+    // 头部所在格子被占据超过一次，说明与身体重叠
+    auto head = segmentAt(0);
+    return occupancyAt(head.first, head.second) > 1;
 }
 
 void Snake::changeDirection(Direction newDirection) {
@@ -72,8 +94,12 @@ void Snake::changeDirection(Direction newDirection) {
     direction = newDirection;
 }
 
-const std::list<std::pair<int, int>>& Snake::getBody() const {
-    return body;
+void Snake::setDirection(Direction newDirection) {
+    direction = newDirection;
+}
+
+Snake::Body Snake::getBody() const {
+    return Body(this);
 }
 
 bool Snake::getIsAlive() const {
@@ -88,6 +114,88 @@ Direction Snake::getDirection() const {
     return direction;
 }
 
-void Snake::setBody(const std::list<std::pair<int, int>>& newBody) {
-    body = newBody;
-} 
\ No newline at end of file
+void Snake::setBody(const std::vector<Segment>& newBody) {
+    std::fill(occupancy.begin(), occupancy.end(), 0);
+    bodyHash = 0;
+    bodyPower = 1;
+    headIndex = 0;
+    length = 0;
+    reserveFor(newBody.size());
+    for (const auto& segment : newBody) {
+        pushBack(segment);
+    }
+}
+
+bool Snake::isOccupied(int x, int y) const {
+    return occupancyAt(x, y) > 0;
+}
+
+int Snake::occupancyAt(int x, int y) const {
+    if (!inBoard(x, y)) return 0;
+    return occupancy[static_cast<std::size_t>(y) * boardWidth + x];
+}
+
+std::uint64_t Snake::getHash() const {
+    const Segment& head = segmentAt(0);
+    std::uint64_t headKey = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(head.first)) << 32) |
+                            static_cast<std::uint32_t>(head.second);
+    return bodyHash ^
+           Zobrist::key(Zobrist::Feature::HEAD, headKey) ^
+           Zobrist::key(Zobrist::Feature::DIRECTION, static_cast<std::uint64_t>(direction)) ^
+           Zobrist::key(Zobrist::Feature::LENGTH, length);
+}
+
+void Snake::reserveFor(std::size_t count) {
+    if (count <= ring.size()) return;
+
+    std::size_t capacity = ring.size();
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    // 按从头到尾的顺序搬到新缓冲区，蛇头回到下标 0
+    std::vector<Segment> newRing(capacity);
+    for (std::size_t i = 0; i < length; ++i) {
+        newRing[i] = segmentAt(i);
+    }
+    ring.swap(newRing);
+    headIndex = 0;
+}
+
+void Snake::pushFront(const Segment& segment) {
+    reserveFor(length + 1);
+    headIndex = (headIndex + ring.size() - 1) & (ring.size() - 1);
+    ring[headIndex] = segment;
+    ++length;
+    bodyHash = bodyHash * ORDER_BASE + segmentKey(segment);
+    bodyPower *= ORDER_BASE;
+    occupy(segment);
+}
+
+void Snake::pushBack(const Segment& segment) {
+    reserveFor(length + 1);
+    ring[(headIndex + length) & (ring.size() - 1)] = segment;
+    ++length;
+    bodyHash += segmentKey(segment) * bodyPower;
+    bodyPower *= ORDER_BASE;
+    occupy(segment);
+}
+
+void Snake::popBack() {
+    bodyPower *= ORDER_BASE_INVERSE;
+    bodyHash -= segmentKey(segmentAt(length - 1)) * bodyPower;
+    vacate(segmentAt(length - 1));
+    --length;
+}
+
+void Snake::occupy(const Segment& segment) {
+    // 越界的蛇头不记录占用，碰撞由 checkCollision 负责
+    if (inBoard(segment.first, segment.second)) {
+        ++occupancy[static_cast<std::size_t>(segment.second) * boardWidth + segment.first];
+    }
+}
+
+void Snake::vacate(const Segment& segment) {
+    if (inBoard(segment.first, segment.second)) {
+        --occupancy[static_cast<std::size_t>(segment.second) * boardWidth + segment.first];
+    }
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #ifndef SNAKE_H
 #define SNAKE_H
 
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 // 方向枚举
 enum class Direction {
@@ -14,22 +17,82 @@ enum class Direction {
 
 class Snake {
 public:
-    Snake(int startX, int startY);        // 构造函数
+    using Segment = std::pair<int, int>;
+
+    // 蛇身只读视图，按从头到尾的顺序遍历环形缓冲区
+    class Body {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Segment;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Segment*;
+            using reference = const Segment&;
+
+            const_iterator() : snake(nullptr), index(0) {}
+            const_iterator(const Snake* s, std::size_t i) : snake(s), index(i) {}
+            reference operator*() const { return snake->segmentAt(index); }
+            pointer operator->() const { return &snake->segmentAt(index); }
+            const_iterator& operator++() { ++index; return *this; }
+            const_iterator operator++(int) { const_iterator old = *this; ++index; return old; }
+            bool operator==(const const_iterator& other) const { return index == other.index; }
+            bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+        private:
+            const Snake* snake;
+            std::size_t index;
+        };
+
+        explicit Body(const Snake* s) : snake(s) {}
+        const_iterator begin() const { return const_iterator(snake, 0); }
+        const_iterator end() const { return const_iterator(snake, snake->length); }
+        const Segment& front() const { return snake->segmentAt(0); }
+        const Segment& back() const { return snake->segmentAt(snake->length - 1); }
+        const Segment& operator[](std::size_t i) const { return snake->segmentAt(i); }
+        std::size_t size() const { return snake->length; }
+        bool empty() const { return snake->length == 0; }
+
+    private:
+        const Snake* snake;
+    };
+
+    Snake(int startX, int startY, int boardWidth, int boardHeight);  // 构造函数
     void move();                          // 移动蛇
     void grow();                          // 增长蛇身
     bool checkCollision(int width, int height) const;  // 检查碰撞
-    bool isCollidingWithSelf() const;           // 检查是否撞到自己
+    bool isCollidingWithSelf() const;           // 检查是否撞到自己（O(1)）
     void changeDirection(Direction newDirection);      // 改变方向
-    const std::list<std::pair<int, int>>& getBody() const;  // 获取蛇身
+    void setDirection(Direction newDirection);         // 直接设置方向（读档用，不做转向检查）
+    Body getBody() const;                       // 获取蛇身
     bool getIsAlive() const;                    // 获取存活状态
     void setAlive(bool alive);                  // 设置存活状态
     Direction getDirection() const;               // 获取当前方向
-    void setBody(const std::list<std::pair<int, int>>& newBody);  // 设置蛇身
+    void setBody(const std::vector<Segment>& newBody);  // 设置蛇身（从头到尾）
+    bool isOccupied(int x, int y) const;        // 指定格子是否被蛇身占据（O(1)）
+    int occupancyAt(int x, int y) const;        // 指定格子上重叠的蛇身节数
+    std::uint64_t getHash() const;              // 蛇的 Zobrist 哈希（从头到尾的蛇身顺序、方向、长度），O(1)
 
 private:
-    std::list<std::pair<int, int>> body;  // 蛇身体，使用链表存储坐标
+    std::vector<Segment> ring;            // 蛇身环形缓冲区，容量为 2 的幂
+    std::size_t headIndex;                // 蛇头在缓冲区中的下标
+    std::size_t length;                   // 蛇身长度
+    std::vector<std::uint16_t> occupancy; // 每个格子被蛇身占据的次数，随移动增量维护
+    std::uint64_t bodyHash;               // 第 i 节的键乘以 ORDER_BASE^i 之和（模 2^64），两端进出时增量维护
+    std::uint64_t bodyPower;              // ORDER_BASE^length
+    int boardWidth;
+    int boardHeight;
     Direction direction;                   // 当前移动方向
     bool isAlive;                         // 蛇是否存活
+
+    const Segment& segmentAt(std::size_t i) const { return ring[(headIndex + i) & (ring.size() - 1)]; }
+    void reserveFor(std::size_t count);
+    void pushFront(const Segment& segment);
+    void pushBack(const Segment& segment);
+    void popBack();
+    void occupy(const Segment& segment);
+    void vacate(const Segment& segment);
+    bool inBoard(int x, int y) const { return x >= 0 && x < boardWidth && y >= 0 && y < boardHeight; }
 };
 
-#endif // SNAKE_H 
\ No newline at end of file
+#endif // SNAKE_H 
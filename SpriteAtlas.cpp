@@ -0,0 +1,49 @@
+#include "SpriteAtlas.h"
+#include <QPainter>
+#include <cstring>
+
+SpriteAtlas::SpriteAtlas() : cellPixels(0) {
+}
+
+void SpriteAtlas::rebuild(int size) {
+    cellPixels = size;
+    int count = static_cast<int>(Sprite::COUNT);
+    // 贴图画在黑色背景上，拷贝时无需混合
+    atlas = QImage(cellPixels * count, cellPixels, QImage::Format_RGB32);
+    atlas.fill(Qt::black);
+
+    QPainter painter(&atlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    qreal inset = cellPixels > 2 ? 1 : 0;  // 格子间留出 1 像素间隙
+    qreal radius = cellPixels / 4.0;
+    auto cellRect = [&](Sprite sprite) {
+        return QRectF(static_cast<int>(sprite) * cellPixels + inset, inset,
+                      cellPixels - 2 * inset, cellPixels - 2 * inset);
+    };
+
+    painter.setBrush(Qt::green);
+    painter.drawRoundedRect(cellRect(Sprite::BODY), radius, radius);
+    painter.setBrush(QColor(173, 255, 47));  // 蛇头颜色略浅，便于分辨方向
+    painter.drawRoundedRect(cellRect(Sprite::HEAD), radius, radius);
+    painter.setBrush(Qt::red);
+    painter.drawEllipse(cellRect(Sprite::FOOD_NORMAL));
+    painter.setBrush(Qt::yellow);
+    painter.drawEllipse(cellRect(Sprite::FOOD_SPECIAL));
+    painter.setBrush(Qt::gray);
+    painter.drawRect(cellRect(Sprite::OBSTACLE));
+}
+
+void SpriteAtlas::blit(QImage& target, int cellX, int cellY, Sprite sprite) const {
+    int x = cellX * cellPixels;
+    int y = cellY * cellPixels;
+    if (x < 0 || y < 0 || x + cellPixels > target.width() || y + cellPixels > target.height()) return;
+
+    // 两幅图都是 32 位像素，逐行 memcpy
+    std::size_t rowBytes = static_cast<std::size_t>(cellPixels) * 4;
+    std::size_t sourceOffset = static_cast<std::size_t>(static_cast<int>(sprite) * cellPixels) * 4;
+    for (int row = 0; row < cellPixels; ++row) {
+        std::memcpy(target.scanLine(y + row) + static_cast<std::size_t>(x) * 4,
+                    atlas.constScanLine(row) + sourceOffset, rowBytes);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include <QImage>
+
+// 格子贴图集：每种格子只在格子尺寸变化时用 QPainter 光栅化一次，
+// 之后按扫描线直接拷贝到帧缓冲，不再逐格调用抗锯齿绘图。
+class SpriteAtlas {
+public:
+    enum class Sprite {
+        EMPTY,
+        BODY,
+        HEAD,
+        FOOD_NORMAL,
+        FOOD_SPECIAL,
+        OBSTACLE,
+        COUNT
+    };
+
+    SpriteAtlas();
+    void rebuild(int cellPixels);  // 按格子的物理像素尺寸重新光栅化所有贴图
+    int getCellPixels() const { return cellPixels; }
+    QImage::Format getFormat() const { return atlas.format(); }
+    const QImage& getImage() const { return atlas; }
+    QRect spriteRect(Sprite sprite) const { return QRect(static_cast<int>(sprite) * cellPixels, 0, cellPixels, cellPixels); }
+    void blit(QImage& target, int cellX, int cellY, Sprite sprite) const;  // 把贴图拷贝到目标图像的 (cellX, cellY) 格子
+
+private:
+    QImage atlas;    // 所有贴图横向排成一行
+    int cellPixels;
+};
+
+#endif // SPRITEATLAS_H
@@ -0,0 +1,44 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者的无锁有界队列，容量为 2 的幂。
+// 生产者只写 tail，消费者只写 head，两个下标分开放在不同缓存行上。
+template<typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "容量必须是 2 的幂");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // 生产者：队列满时返回 false
+    bool push(const T& item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：队列空时返回 false
+    bool pop(T& item) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head;  // 下一个要读取的位置
+    alignas(64) std::atomic<std::size_t> tail;  // 下一个要写入的位置
+    T items[Capacity];
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,60 @@
+#include "TranspositionTable.h"
+#include <cstring>
+
+static_assert(sizeof(TranspositionTable::Entry) == 16, "置换表条目应为 16 字节");
+
+TranspositionTable::TranspositionTable(std::size_t sizeInBytes) : mask(0) {
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= sizeInBytes) {
+        count *= 2;
+    }
+    buckets.resize(count);
+    mask = count - 1;
+    clear();
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& result) const {
+    const Bucket& bucket = buckets[key & mask];
+    for (const Entry& entry : bucket.entries) {
+        if (entry.key == key && key != 0) {
+            result = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, std::int32_t value, Direction move, int depth, std::uint8_t flags) {
+    Bucket& bucket = buckets[key & mask];
+
+    // 优先覆盖同键条目，其次空条目，否则替换深度最小的条目（深度相同时取桶中靠前的一个）
+    Entry* target = &bucket.entries[0];
+    for (Entry& entry : bucket.entries) {
+        if (entry.key == key || entry.key == 0) {
+            target = &entry;
+            break;
+        }
+        if (entry.depth < target->depth) {
+            target = &entry;
+        }
+    }
+
+    target->key = key;
+    target->value = value;
+    target->move = static_cast<std::uint8_t>(move);
+    target->depth = static_cast<std::uint8_t>(depth > 255 ? 255 : (depth < 0 ? 0 : depth));
+    target->flags = flags;
+}
+
+void TranspositionTable::remove(std::uint64_t key) {
+    Bucket& bucket = buckets[key & mask];
+    for (Entry& entry : bucket.entries) {
+        if (entry.key == key) {
+            entry = Entry();
+        }
+    }
+}
+
+void TranspositionTable::clear() {
+    std::memset(static_cast<void*>(buckets.data()), 0, buckets.size() * sizeof(Bucket));
+}
@@ -0,0 +1,42 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "Snake.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 固定大小的置换表，以 Zobrist 状态哈希为键
+// 每个桶恰好占一条 64 字节缓存行，容纳 4 个条目；探查和写入都不分配内存，
+// 可供寻路、前瞻搜索等多个规划器共用。
+class TranspositionTable {
+public:
+    struct Entry {
+        std::uint64_t key;        // 完整状态哈希，0 表示空条目
+        std::int32_t value;       // 规划器自定义的评估值（如路径长度）
+        std::uint8_t move;        // 最佳方向（Direction 的数值）
+        std::uint8_t depth;       // 搜索深度，替换时优先保留深度大的条目
+        std::uint8_t flags;       // 规划器自定义标记
+
+        Direction getMove() const { return static_cast<Direction>(move); }
+    };
+
+    explicit TranspositionTable(std::size_t sizeInBytes);  // 大小向下取整为 2 的幂个桶
+
+    bool probe(std::uint64_t key, Entry& result) const;
+    void store(std::uint64_t key, std::int32_t value, Direction move, int depth, std::uint8_t flags = 0);
+    void remove(std::uint64_t key);  // 删除该键的条目（如校验失败的缓存结果）
+    void clear();
+
+private:
+    static const int ENTRIES_PER_BUCKET = 4;
+
+    struct alignas(64) Bucket {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+
+    std::vector<Bucket> buckets;
+    std::size_t mask;
+};
+
+#endif // TRANSPOSITIONTABLE_H
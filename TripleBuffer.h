@@ -0,0 +1,40 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// 单写单读的无锁三缓冲：写端总有一个独占的槽位可写，读端总能拿到最近一次发布的完整数据。
+// 两端只通过一个原子字节交换槽位下标，写端从不等待读端，读端也不会读到写了一半的数据。
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    // 写端：在 writeBuffer() 上写好数据后调用 publish()，之后 writeBuffer() 换成另一个槽位
+    T& writeBuffer() { return buffers[writeIndex]; }
+    void publish() {
+        std::uint8_t previous = middle.exchange(static_cast<std::uint8_t>(writeIndex | FRESH), std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // 读端：有新数据时换到最新的槽位并返回 true，readBuffer() 在下次 acquire 之前保持不变
+    bool acquire() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        std::uint8_t previous = middle.exchange(static_cast<std::uint8_t>(readIndex), std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+private:
+    static constexpr std::uint8_t FRESH = 4;       // 中间槽位有尚未读取的新数据
+    static constexpr std::uint8_t INDEX_MASK = 3;
+
+    T buffers[3];
+    alignas(64) std::atomic<std::uint8_t> middle;  // 中间槽位下标 | FRESH
+    alignas(64) std::uint8_t writeIndex;           // 只由写端访问
+    alignas(64) std::uint8_t readIndex;            // 只由读端访问
+};
+
+#endif // TRIPLEBUFFER_H
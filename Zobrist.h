@@ -0,0 +1,32 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Zobrist 哈希键
+// 每个（特征, 格子）对应一个固定的 64 位伪随机键，状态哈希为所有特征键的异或，
+// 状态变化时只需异或进出的键即可 O(1) 更新。
+// 键由 splitmix64 混合函数即时算出，任意棋盘大小都无需存储键表。
+namespace Zobrist {
+
+enum class Feature : std::uint64_t {
+    BODY = 1,          // 蛇身的一节（蛇身按从头到尾的顺序加权组合，见 Snake::getHash）
+    HEAD,              // 蛇头所在格子
+    DIRECTION,         // 当前移动方向
+    LENGTH,            // 蛇身长度（区分尾部重叠的待增长状态）
+    FOOD_NORMAL,       // 普通食物位置
+    FOOD_SPECIAL,      // 特殊食物位置
+    OBSTACLE           // 障碍物位置
+};
+
+inline std::uint64_t key(Feature feature, std::uint64_t index) {
+    std::uint64_t z = (static_cast<std::uint64_t>(feature) << 56) ^ index;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace Zobrist
+
+#endif // ZOBRIST_H
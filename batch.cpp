@@ -0,0 +1,192 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* difficultyName(Game::Difficulty difficulty) {
+    switch (difficulty) {
+        case Game::Difficulty::EASY: return "easy";
+        case Game::Difficulty::NORMAL: return "normal";
+        case Game::Difficulty::HARD: return "hard";
+    }
+    return "?";
+}
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --games N         number of games per difficulty (default 10000)\n"
+                "  --threads N       worker threads (default: all cores)\n"
+                "  --difficulty D    easy | normal | hard | all (default all)\n"
+                "  --width N         board width (default 20)\n"
+                "  --height N        board height (default 20)\n"
+                "  --seed N          base seed (default 1)\n"
+                "  --max-ticks N     tick limit per game (default 200000)\n"
+                "  --chunk N         games per scheduling task (default 16)\n"
+                "  --strategy S      autopilot: greedy | hamilton (default greedy)\n"
+                "  --replay FILE     replay FILE headlessly and check its recorded end state\n"
+                "                    (repeatable; no batch is run)\n",
+                program);
+}
+
+void printReport(const BatchRunner& runner, const BatchStats& stats, const BatchOptions& options) {
+    static const char* ENDING_NAMES[BatchStats::ENDING_COUNT] = {
+        "won", "hit wall", "hit self", "hit obstacle", "stalled", "tick limit"
+    };
+
+    double games = stats.games > 0 ? static_cast<double>(stats.games) : 1.0;
+    std::printf("== difficulty %s, board %dx%d, %s autopilot, %lld games, %d threads ==\n",
+                difficultyName(options.game.difficulty), options.game.board.width, options.game.board.height,
+                options.game.autoPathStrategy == Game::AutoPathStrategy::HAMILTON ? "hamilton" : "greedy",
+                stats.games, static_cast<int>(runner.getWorkerReports().size()));
+    std::printf("mean score        %.2f\n", stats.totalScore / games);
+    std::printf("mean game length  %.1f ticks\n", stats.ticks / games);
+    std::printf("mean snake length %.1f\n", stats.totalLength / games);
+    std::printf("plan p50/p99      %.1f/%.1f us (%llu searches)\n",
+                stats.planLatency.percentile(0.5) / 1e3, stats.planLatency.percentile(0.99) / 1e3,
+                static_cast<unsigned long long>(stats.planLatency.getCount()));
+
+    if (options.game.autoPathStrategy == Game::AutoPathStrategy::HAMILTON) {
+        std::printf("partial cycles    %lld games (%.1f uncovered cells each)\n", stats.incompleteCycles,
+                    stats.incompleteCycles > 0 ? static_cast<double>(stats.uncoveredCells) / stats.incompleteCycles : 0.0);
+    }
+    std::printf("endings:\n");
+    for (int i = 0; i < BatchStats::ENDING_COUNT; ++i) {
+        std::printf("  %-13s %10lld  %6.2f%%\n", ENDING_NAMES[i], stats.endings[i], 100.0 * stats.endings[i] / games);
+    }
+
+    // 直方图最多显示 HISTOGRAM_ROWS 行，按食物数分组
+    const std::size_t HISTOGRAM_ROWS = 20;
+    std::size_t binWidth = (stats.scoreHistogram.size() + HISTOGRAM_ROWS - 1) / HISTOGRAM_ROWS;
+    binWidth = binWidth == 0 ? 1 : binWidth;
+    std::printf("score histogram (food eaten: games):\n");
+    for (std::size_t first = 0; first < stats.scoreHistogram.size(); first += binWidth) {
+        std::size_t last = std::min(first + binWidth, stats.scoreHistogram.size()) - 1;
+        long long count = 0;
+        for (std::size_t i = first; i <= last; ++i) {
+            count += stats.scoreHistogram[i];
+        }
+        std::printf("  %5zu-%-5zu %10lld\n", first, last, count);
+    }
+
+    std::printf("workers:\n");
+    const auto& reports = runner.getWorkerReports();
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        const WorkerReport& report = reports[i];
+        double tps = report.seconds > 0.0 ? report.stats.ticks / report.seconds : 0.0;
+        std::printf("  #%-3zu games %8lld  ticks %12llu  %12.0f ticks/s  steals %lld\n",
+                    i, report.stats.games, static_cast<unsigned long long>(report.stats.ticks), tps, report.steals);
+    }
+    double elapsed = runner.getElapsedSeconds();
+    std::printf("total: %.3f s, %.0f ticks/s, %.1f games/s\n\n",
+                elapsed, elapsed > 0.0 ? stats.ticks / elapsed : 0.0, elapsed > 0.0 ? stats.games / elapsed : 0.0);
+}
+
+// 回放录像并校验结束状态，全部一致时返回 true
+bool verifyReplays(const std::vector<std::string>& files) {
+    int failures = 0;
+    for (const auto& file : files) {
+        Replay replay;
+        if (!replay.load(file)) {
+            std::printf("ERROR %s: cannot read replay\n", file.c_str());
+            ++failures;
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<Game> game = replay.play();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool ok = replay.matches(*game);
+        failures += ok ? 0 : 1;
+        std::printf("%s %s: %llu ticks, score %d (expected %llu ticks, score %d), %.0f ticks/s\n",
+                    ok ? "PASS " : "FAIL ", file.c_str(),
+                    static_cast<unsigned long long>(game->getTickCount()), game->getScore(),
+                    static_cast<unsigned long long>(replay.endTick), replay.endScore,
+                    seconds > 0.0 ? game->getTickCount() / seconds : 0.0);
+    }
+    std::printf("%zu replays, %d failed\n", files.size(), failures);
+    return failures == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BatchOptions options;
+    std::string difficulty = "all";
+    int width = BoardSize::DEFAULT_SIZE;
+    int height = BoardSize::DEFAULT_SIZE;
+    std::vector<std::string> replays;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (value == nullptr) {
+            std::fprintf(stderr, "missing value for %s\n", arg);
+            return 1;
+        }
+        if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoll(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--difficulty") == 0) {
+            difficulty = value;
+        } else if (std::strcmp(arg, "--width") == 0) {
+            width = std::atoi(value);
+        } else if (std::strcmp(arg, "--height") == 0) {
+            height = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--chunk") == 0) {
+            options.chunkSize = std::atoi(value);
+        } else if (std::strcmp(arg, "--strategy") == 0) {
+            if (std::strcmp(value, "greedy") == 0) {
+                options.game.autoPathStrategy = Game::AutoPathStrategy::GREEDY;
+            } else if (std::strcmp(value, "hamilton") == 0) {
+                options.game.autoPathStrategy = Game::AutoPathStrategy::HAMILTON;
+            } else {
+                std::fprintf(stderr, "unknown strategy %s\n", value);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            replays.push_back(value);
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+    options.game.board = BoardSize(width, height);
+
+    if (!replays.empty()) {
+        return verifyReplays(replays) ? 0 : 1;
+    }
+
+    std::vector<Game::Difficulty> difficulties;
+    if (difficulty == "easy" || difficulty == "all") difficulties.push_back(Game::Difficulty::EASY);
+    if (difficulty == "normal" || difficulty == "all") difficulties.push_back(Game::Difficulty::NORMAL);
+    if (difficulty == "hard" || difficulty == "all") difficulties.push_back(Game::Difficulty::HARD);
+    if (difficulties.empty()) {
+        std::fprintf(stderr, "unknown difficulty %s\n", difficulty.c_str());
+        return 1;
+    }
+
+    for (Game::Difficulty d : difficulties) {
+        options.game.difficulty = d;
+        BatchRunner runner(options);
+        BatchStats stats = runner.run();
+        printReport(runner, stats, options);
+    }
+    return 0;
+}
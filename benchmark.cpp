@@ -0,0 +1,446 @@
+#include "game.h"
+#include "Arena.h"
+#include "FreeCellIndex.h"
+#include "HamiltonCycle.h"
+#include "LatencyHistogram.h"
+#include "PackedBody.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 直接测量 Game 的私有热点函数
+class GameBenchmark {
+public:
+    static bool isValidPosition(const Game& game, int x, int y) { return game.isValidPosition(x, y); }
+    static Direction findPathToFood(Game& game) {
+        game.getTranspositionTable().clear();  // 不让置换表命中掩盖搜索本身的耗时
+        return game.findPathToFood();
+    }
+};
+
+namespace {
+
+struct Options {
+    int width = BoardSize::DEFAULT_SIZE;
+    int height = BoardSize::DEFAULT_SIZE;
+    std::vector<int> lengths = {3, 50, 150};           // 蛇长
+    std::vector<double> fills = {0.0, 0.5, 0.9, 0.99};  // 生成食物时棋盘被占据的比例
+    int seeds = 8;                                     // 寻路测试使用的随机局面数
+    std::vector<int> snakes = {16, 128, 400};          // 竞技场蛇数
+    std::uint64_t seed = 1;
+    double minTimeMs = 200.0;                          // 每项测试的最短计时
+    bool json = false;
+    std::string filter;                                // 只运行名称包含该字符串的测试
+};
+
+struct Result {
+    std::string name;
+    std::string params;  // 形如 "length=50"
+    unsigned long long operations;
+    double seconds;
+};
+
+volatile std::uint64_t sink;  // 防止被测调用被优化掉
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --width N         board width (default 20)\n"
+                "  --height N        board height (default 20)\n"
+                "  --lengths L,...   snake lengths (default 3,50,150)\n"
+                "  --fills F,...     board fill ratios for food spawning (default 0,0.5,0.9,0.99)\n"
+                "  --seeds N         seeded boards for path finding (default 8)\n"
+                "  --snakes N,...    arena snake counts, on a 256x256 board (default 16,128,400)\n"
+                "  --seed N          base seed (default 1)\n"
+                "  --min-time MS     minimum measuring time per benchmark (default 200)\n"
+                "  --filter TEXT     run only benchmarks whose name contains TEXT\n"
+                "  --json            print results as JSON\n",
+                program);
+}
+
+template <typename T, typename Parse>
+bool parseList(const char* value, std::vector<T>& list, Parse parse) {
+    list.clear();
+    std::string text(value);
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        std::size_t end = text.find(',', begin);
+        if (end == std::string::npos) end = text.size();
+        if (end == begin) return false;
+        list.push_back(parse(text.substr(begin, end - begin)));
+        begin = end + 1;
+    }
+    return !list.empty();
+}
+
+// 以批为单位重复执行 body(batch)，直到累计时间不少于 minTimeMs
+template <typename Body>
+Result measure(const Options& options, const std::string& name, const std::string& params, Body body) {
+    unsigned long long operations = 0;
+    std::uint64_t elapsed = 0;
+    std::uint64_t minNs = static_cast<std::uint64_t>(options.minTimeMs * 1e6);
+    unsigned long long batch = 1;
+    while (elapsed < minNs) {
+        std::uint64_t start = steadyClockNs();
+        body(batch);
+        elapsed += steadyClockNs() - start;
+        operations += batch;
+        if (batch < (1ULL << 24)) batch *= 2;
+    }
+    return {name, params, operations, elapsed / 1e9};
+}
+
+// 沿空棋盘上的哈密顿回路排出指定长度的蛇身，返回回路的逆查表（序号 -> 格子）
+std::vector<std::pair<int, int>> cycleCells(const HamiltonCycle& cycle, int width, int height) {
+    std::vector<std::pair<int, int>> cells(static_cast<std::size_t>(cycle.length()));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (cycle.contains(x, y)) {
+                cells[cycle.orderAt(x, y)] = {x, y};
+            }
+        }
+    }
+    return cells;
+}
+
+Direction directionBetween(std::pair<int, int> from, std::pair<int, int> to) {
+    if (to.first > from.first) return Direction::RIGHT;
+    if (to.first < from.first) return Direction::LEFT;
+    if (to.second > from.second) return Direction::DOWN;
+    return Direction::UP;
+}
+
+void benchSnake(const Options& options, std::vector<Result>& results) {
+    HamiltonCycle cycle(options.width, options.height);
+    cycle.build(std::vector<std::uint8_t>(static_cast<std::size_t>(options.width) * options.height, 0));
+    std::vector<std::pair<int, int>> cells = cycleCells(cycle, options.width, options.height);
+
+    for (int length : options.lengths) {
+        if (length < 1 || length >= cycle.length()) continue;
+        std::string params = "length=" + std::to_string(length);
+
+        // 蛇头在回路序号 length - 1 处，蛇身沿回路向后排列；移动时沿回路前进，不会撞到自己
+        std::vector<std::pair<int, int>> body;
+        for (int i = length - 1; i >= 0; --i) {
+            body.push_back(cells[i]);
+        }
+        Snake snake(options.width / 2, options.height / 2, options.width, options.height);
+        snake.setBody(body);
+        if (length > 1) snake.setDirection(directionBetween(body[1], body[0]));
+
+        if (options.filter.empty() || std::string("snake_move").find(options.filter) != std::string::npos) {
+            results.push_back(measure(options, "snake_move", params, [&](unsigned long long batch) {
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    auto head = snake.getBody().front();
+                    snake.changeDirection(cycle.nextAt(head.first, head.second));
+                    snake.move();
+                }
+                sink = snake.getHash();
+            }));
+        }
+        if (options.filter.empty() || std::string("body_pack").find(options.filter) != std::string::npos) {
+            PackedBody packed;
+            results.push_back(measure(options, "body_pack", params, [&](unsigned long long batch) {
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    packed.pack(snake);
+                }
+                sink = packed.size();
+            }));
+        }
+        if (options.filter.empty() || std::string("body_unpack").find(options.filter) != std::string::npos) {
+            PackedBody packed;
+            packed.pack(snake);
+            std::vector<std::pair<int, int>> cells;
+            results.push_back(measure(options, "body_unpack", params, [&](unsigned long long batch) {
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    packed.unpack(cells);
+                }
+                sink = cells.size();
+            }));
+        }
+        if (options.filter.empty() || std::string("snake_self_collision").find(options.filter) != std::string::npos) {
+            results.push_back(measure(options, "snake_self_collision", params, [&](unsigned long long batch) {
+                std::uint64_t hits = 0;
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    hits += snake.isCollidingWithSelf() ? 1 : 0;
+                }
+                sink = hits;
+            }));
+        }
+    }
+}
+
+void benchFood(const Options& options, std::vector<Result>& results) {
+    if (!options.filter.empty() && std::string("food_generate").find(options.filter) == std::string::npos) return;
+    int cellCount = options.width * options.height;
+    for (double fill : options.fills) {
+        // 按比例随机占据格子，其余格子放入空闲索引
+        FreeCellIndex freeCells(cellCount);
+        Random rng(options.seed);
+        for (int cell = 0; cell < cellCount; ++cell) {
+            if (rng.nextDouble() >= fill) {
+                freeCells.insert(cell);
+            }
+        }
+        if (freeCells.empty()) continue;
+
+        char params[32];
+        std::snprintf(params, sizeof(params), "fill=%.2f", fill);
+        Food food;
+        results.push_back(measure(options, "food_generate", params, [&](unsigned long long batch) {
+            std::uint64_t total = 0;
+            for (unsigned long long i = 0; i < batch; ++i) {
+                food.generateNew(options.width, freeCells, rng);
+                total += static_cast<std::uint64_t>(food.getPosition().first);
+            }
+            sink = total;
+        }));
+    }
+}
+
+// 可复现的局面：按种子开局（含该难度的障碍物），蛇身沿避开障碍物的哈密顿回路排出指定长度，食物随机放在空格上
+bool makeBoard(const Options& options, std::uint64_t seed, int length, Game& game) {
+    GameState state;
+    game.captureState(state);
+    std::vector<std::uint8_t> blocked(static_cast<std::size_t>(options.width) * options.height, 0);
+    for (const auto& obstacle : state.obstacles) {
+        blocked[static_cast<std::size_t>(obstacle.second) * options.width + obstacle.first] = 1;
+    }
+    HamiltonCycle cycle(options.width, options.height);
+    cycle.build(blocked);
+    if (length < 2 || length >= cycle.length()) return false;
+    std::vector<std::pair<int, int>> cells = cycleCells(cycle, options.width, options.height);
+
+    Random rng(seed);
+    int headOrder = static_cast<int>(rng.uniform(static_cast<std::uint32_t>(cycle.length())));
+    std::vector<std::uint8_t> occupied = blocked;
+    state.body.clear();
+    for (int i = 0; i < length; ++i) {
+        auto cell = cells[(headOrder - i + cycle.length()) % cycle.length()];
+        state.body.push_back(cell);
+        occupied[static_cast<std::size_t>(cell.second) * options.width + cell.first] = 1;
+    }
+    state.direction = static_cast<std::uint8_t>(directionBetween(state.body[1], state.body[0]));
+
+    std::vector<std::pair<int, int>> freeCells;
+    for (int y = 1; y < options.height - 1; ++y) {
+        for (int x = 1; x < options.width - 1; ++x) {
+            if (!occupied[static_cast<std::size_t>(y) * options.width + x]) freeCells.push_back({x, y});
+        }
+    }
+    if (freeCells.empty()) return false;
+    state.food = freeCells[rng.uniform(static_cast<std::uint32_t>(freeCells.size()))];
+    state.foodType = static_cast<std::uint8_t>(Food::Type::NORMAL);
+    state.path.clear();
+    state.alwaysAutoPath = true;
+    return game.restoreState(state);
+}
+
+void benchGame(const Options& options, std::vector<Result>& results) {
+    GameConfig config;
+    config.board = BoardSize(options.width, options.height);
+    config.difficulty = Game::Difficulty::HARD;
+
+    // 随机查询坐标，包含越界位置
+    std::vector<std::pair<int, int>> queries;
+    Random queryRng(options.seed);
+    for (int i = 0; i < 4096; ++i) {
+        queries.push_back({static_cast<int>(queryRng.uniform(static_cast<std::uint32_t>(options.width + 2))) - 1,
+                           static_cast<int>(queryRng.uniform(static_cast<std::uint32_t>(options.height + 2))) - 1});
+    }
+
+    for (int length : options.lengths) {
+        std::string params = "length=" + std::to_string(length);
+        config.seed = options.seed;
+        Game game(config);
+        if (!makeBoard(options, options.seed, length, game)) continue;
+
+        if (options.filter.empty() || std::string("game_is_obstacle").find(options.filter) != std::string::npos) {
+            results.push_back(measure(options, "game_is_obstacle", params, [&](unsigned long long batch) {
+                std::uint64_t hits = 0;
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    const auto& q = queries[i & 4095];
+                    hits += game.isObstacle(q.first, q.second) ? 1 : 0;
+                }
+                sink = hits;
+            }));
+        }
+        if (options.filter.empty() || std::string("game_is_valid_position").find(options.filter) != std::string::npos) {
+            results.push_back(measure(options, "game_is_valid_position", params, [&](unsigned long long batch) {
+                std::uint64_t hits = 0;
+                for (unsigned long long i = 0; i < batch; ++i) {
+                    const auto& q = queries[i & 4095];
+                    hits += GameBenchmark::isValidPosition(game, q.first, q.second) ? 1 : 0;
+                }
+                sink = hits;
+            }));
+        }
+
+        // 每次搜索都在新的种子局面上进行，局面在计时外准备
+        if (options.filter.empty() || std::string("game_find_path").find(options.filter) != std::string::npos) {
+            std::vector<std::unique_ptr<Game>> boards;
+            for (int i = 0; i < options.seeds; ++i) {
+                config.seed = options.seed + static_cast<std::uint64_t>(i);
+                std::unique_ptr<Game> board(new Game(config));
+                if (makeBoard(options, config.seed, length, *board)) boards.push_back(std::move(board));
+            }
+            if (!boards.empty()) {
+                std::vector<GameState> states(boards.size());
+                for (std::size_t i = 0; i < boards.size(); ++i) boards[i]->captureState(states[i]);
+                unsigned long long operations = 0;
+                std::uint64_t elapsed = 0;
+                std::uint64_t minNs = static_cast<std::uint64_t>(options.minTimeMs * 1e6);
+                std::uint64_t total = 0;
+                while (elapsed < minNs) {
+                    std::size_t i = static_cast<std::size_t>(operations % boards.size());
+                    boards[i]->restoreState(states[i]);
+                    std::uint64_t start = steadyClockNs();
+                    total += static_cast<std::uint64_t>(GameBenchmark::findPathToFood(*boards[i]));
+                    elapsed += steadyClockNs() - start;
+                    ++operations;
+                }
+                sink = total;
+                results.push_back({"game_find_path", params, operations, elapsed / 1e9});
+            }
+        }
+    }
+
+    // 端到端：自动寻路对局连续推进，结束后换种子重开
+    if (options.filter.empty() || std::string("game_update").find(options.filter) != std::string::npos) {
+        for (int d = 0; d <= static_cast<int>(Game::Difficulty::HARD); ++d) {
+            GameConfig loopConfig = config;
+            loopConfig.difficulty = static_cast<Game::Difficulty>(d);
+            loopConfig.alwaysAutoPath = true;
+            loopConfig.seed = options.seed;
+            std::unique_ptr<Game> game(new Game(loopConfig));
+            static const char* DIFFICULTY_NAMES[] = {"easy", "normal", "hard"};
+            results.push_back(measure(options, "game_update", std::string("difficulty=") + DIFFICULTY_NAMES[d],
+                [&](unsigned long long batch) {
+                    for (unsigned long long i = 0; i < batch; ++i) {
+                        if (game->isGameOver()) {
+                            ++loopConfig.seed;
+                            game.reset(new Game(loopConfig));
+                        }
+                        game->update();
+                    }
+                    sink = game->getTickCount();
+                }));
+        }
+    }
+}
+
+// 竞技场整帧推进；棋盘固定为 256x256，先预热让蛇长到稳定长度
+void benchArena(const Options& options, std::vector<Result>& results) {
+    if (!options.filter.empty() && std::string("arena_tick").find(options.filter) == std::string::npos) return;
+    for (int snakes : options.snakes) {
+        ArenaConfig config;
+        config.board = BoardSize(256, 256);
+        config.snakeCount = snakes;
+        config.humanCount = 0;
+        config.foodCount = std::max(32, snakes * 2);
+        config.seed = options.seed;
+        Arena arena(config);
+        for (int i = 0; i < 1000; ++i) arena.update();
+        results.push_back(measure(options, "arena_tick", "snakes=" + std::to_string(arena.getSnakeCount()),
+            [&](unsigned long long batch) {
+                for (unsigned long long i = 0; i < batch; ++i) arena.update();
+                sink = arena.getTickCount();
+            }));
+    }
+}
+
+void printText(const Options& options, const std::vector<Result>& results) {
+    std::printf("== board %dx%d, seed %llu ==\n", options.width, options.height,
+                static_cast<unsigned long long>(options.seed));
+    std::printf("%-24s %-16s %14s %14s %16s\n", "benchmark", "params", "operations", "ns/op", "ops/s");
+    for (const auto& result : results) {
+        double nsPerOp = result.seconds * 1e9 / static_cast<double>(result.operations);
+        std::printf("%-24s %-16s %14llu %14.1f %16.0f\n", result.name.c_str(), result.params.c_str(),
+                    result.operations, nsPerOp, result.operations / result.seconds);
+    }
+}
+
+void printJson(const Options& options, const std::vector<Result>& results) {
+    std::printf("{\n  \"board\": {\"width\": %d, \"height\": %d},\n  \"seed\": %llu,\n  \"results\": [\n",
+                options.width, options.height, static_cast<unsigned long long>(options.seed));
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        // params 形如 "key=value"，输出为 JSON 对象
+        std::string key = result.params.substr(0, result.params.find('='));
+        std::string value = result.params.substr(result.params.find('=') + 1);
+        bool numeric = !value.empty() && std::strspn(value.c_str(), "0123456789.") == value.size();
+        std::printf("    {\"name\": \"%s\", \"params\": {\"%s\": %s%s%s}, \"operations\": %llu, "
+                    "\"seconds\": %.6f, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+                    result.name.c_str(), key.c_str(), numeric ? "" : "\"", value.c_str(), numeric ? "" : "\"",
+                    result.operations, result.seconds, result.seconds * 1e9 / static_cast<double>(result.operations),
+                    result.operations / result.seconds, i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (std::strcmp(arg, "--json") == 0) {
+            options.json = true;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            std::fprintf(stderr, "missing value for %s\n", arg);
+            return 1;
+        }
+        bool ok = true;
+        if (std::strcmp(arg, "--width") == 0) {
+            options.width = BoardSize::clampSide(std::atoi(value));
+        } else if (std::strcmp(arg, "--height") == 0) {
+            options.height = BoardSize::clampSide(std::atoi(value));
+        } else if (std::strcmp(arg, "--lengths") == 0) {
+            ok = parseList(value, options.lengths, [](const std::string& s) { return std::atoi(s.c_str()); });
+        } else if (std::strcmp(arg, "--fills") == 0) {
+            ok = parseList(value, options.fills, [](const std::string& s) { return std::atof(s.c_str()); });
+        } else if (std::strcmp(arg, "--snakes") == 0) {
+            ok = parseList(value, options.snakes, [](const std::string& s) { return std::atoi(s.c_str()); });
+        } else if (std::strcmp(arg, "--seeds") == 0) {
+            options.seeds = std::max(1, std::atoi(value));
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--min-time") == 0) {
+            options.minTimeMs = std::atof(value);
+        } else if (std::strcmp(arg, "--filter") == 0) {
+            options.filter = value;
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "invalid list for %s\n", arg);
+            return 1;
+        }
+        ++i;
+    }
+
+    std::vector<Result> results;
+    benchSnake(options, results);
+    benchFood(options, results);
+    benchGame(options, results);
+    benchArena(options, results);
+
+    if (options.json) {
+        printJson(options, results);
+    } else {
+        printText(options, results);
+    }
+    return 0;
+}
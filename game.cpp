@@ -1,77 +1,110 @@
 #include "game.h"
-#include <fstream>
+#include "SaveFile.h"
+#include "Zobrist.h"
+#include <cstdlib>
 #include <random>
 #include <algorithm>
-#include <queue>
-#include <unordered_set>
 
-Game::Game() : snake(WIDTH / 2, HEIGHT / 2), score(0), highScore(0), paused(false),
-    difficulty(Difficulty::NORMAL), autoPathEnabled(false), isFollowingPath(false) {
-    loadHighScore();
-    food = Food();  // 创建新的食物对象
-    food.generateNew(WIDTH, HEIGHT, snake.getBody(), obstacles);
+Game::Game() : Game(GameConfig()) {
+}
+
+static bool isOpposite(Direction a, Direction b) {
+    return (a == Direction::UP && b == Direction::DOWN) || (a == Direction::DOWN && b == Direction::UP) ||
+           (a == Direction::LEFT && b == Direction::RIGHT) || (a == Direction::RIGHT && b == Direction::LEFT);
+}
+
+// 种子为 0 时从随机设备取一个非零种子
+static std::uint64_t resolveSeed(std::uint64_t seed) {
+    while (seed == 0) {
+        std::random_device rd;
+        seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+    }
+    return seed;
+}
+
+Game::Game(const GameConfig& config) : board(config.board),
+    seed(resolveSeed(config.seed)), rng(seed), initialDifficulty(config.difficulty),
+    alwaysAutoPath(config.alwaysAutoPath),
+    autoPathStrategy(config.autoPathStrategy), autopilotRevision(config.autopilotRevision),
+    snake(board.width / 2, board.height / 2, board.width, board.height), score(0), highScore(std::max(0, config.highScore)), paused(false),
+    difficulty(config.difficulty), obstacleHash(0), obstacleGrid(board.cellCount(), 0),
+    obstacleBits(board.width, board.height), bodyBits(board.width, board.height),
+    freeBits(board.width, board.height), regionBits(board.width, board.height),
+    foodCells(static_cast<int>(board.cellCount())), outcome(Outcome::PLAYING), autoPathEnabled(false),
+    tickCount(0), autoPathStartTick(0),
+    pathSlot(board.cellCount(), -1), isFollowingPath(false), pathFinder(board.width, board.height), releaseTicks(board.cellCount(), 0),
+    transpositionTable(TRANSPOSITION_TABLE_BYTES), cycle(board.width, board.height), cycleValid(false), cycleRun(0),
+    replayable(true), rankable(true), queuedInputs(0), latePlans(0), rewindBuffer(config.rewindBudgetBytes) {
+    if (config.asyncPlanner) {
+        planner.reset(new AsyncPlanner(board.width, board.height));
+    }
+    rebuildCellIndex();
+    spawnFood();
     generateObstacles();
+    recordRewind(false);
+    requestPlan();
 }
 
 Game::~Game() {
-    saveHighScore();
 }
 
 void Game::update() {
-    if (paused) return;
+    if (paused || isGameOver()) return;
+
+    // 每帧应用一个排队的输入，按应用时的帧记入录像
+    if (queuedInputs > 0) {
+        applyQueuedInput();
+    }
+
+    ++tickCount;
 
     // 检查自动寻路状态
-    if (isAutoPathActive()) {
+    Direction cycleDir;
+    if (!isAutoPathActive()) {
+        cycleRun = 0;
+    } else if (autoPathStrategy == AutoPathStrategy::HAMILTON && findCycleDirection(cycleDir)) {
+        if (autopilotRevision < 4) {
+            clearPath();  // 修订 4 起交接路径由回路策略自己跟随
+        }
+        if (cycleDir != snake.getDirection()) {
+            snake.changeDirection(cycleDir);
+        }
+    } else {
+        cycleRun = 0;
+        // 下一步被挡住时先尝试局部绕行，绕不过去再整体重新寻路
+        // （转向被拒绝等原因导致蛇头偏离路径时，路径上记录的格子已不可信，直接重新寻路）
+        if (isFollowingPath && !pathSteps.empty()) {
+            std::pair<int, int> nextPos = advance(snake.getBody().front(), pathSteps.back());
+            bool onTrack = nextPos == pathCells.back();
+            if (autopilotRevision >= 2 && !onTrack) {
+                clearPath();
+            } else if (!isValidPosition(nextPos.first, nextPos.second) && (autopilotRevision < 2 || !repairPath())) {
+                clearPath();
+            }
+        }
+
         // 只有在没有路径或路径已用完时才重新寻找路径
-        if (!isFollowingPath || currentPath.empty()) {
+        if (!isFollowingPath || pathSteps.empty()) {
             Direction newDir = findPathToFood();
             if (newDir != snake.getDirection()) {
                 snake.changeDirection(newDir);
             }
         } else {
             // 使用路径中的下一个方向
-            Direction nextDir = currentPath.front();
-            currentPath.erase(currentPath.begin());
-            
-            // 验证方向是否安全
-            auto head = snake.getBody().front();
-            auto currentBody = snake.getBody();
-            std::pair<int, int> nextPos = head;
-            switch (nextDir) {
-                case Direction::UP: nextPos.second--; break;
-                case Direction::DOWN: nextPos.second++; break;
-                case Direction::LEFT: nextPos.first--; break;
-                case Direction::RIGHT: nextPos.first++; break;
-                default: break;
-            }
-            
-            currentBody.pop_back();
-            currentBody.push_front(nextPos);
-            
-            if (isValidPosition(nextPos.first, nextPos.second, currentBody)) {
-                snake.changeDirection(nextDir);
-            } else {
-                // 如果方向不安全，重新寻找路径
-                isFollowingPath = false;
-                currentPath.clear();
-                Direction newDir = findPathToFood();
-                if (newDir != snake.getDirection()) {
-                    snake.changeDirection(newDir);
-                }
-            }
+            snake.changeDirection(pathSteps.back());
+            pathSteps.pop_back();
+            pathCells.pop_back();
         }
     }
 
-    snake.move();
+    moveSnake();
 
     // 检查是否吃到食物
-    if (snake.getBody().front() == food.getPosition()) {
+    bool ate = snake.getBody().front() == food.getPosition();
+    if (ate) {
         snake.grow();
         score += 10;
-        if (score > highScore) {
-            highScore = score;
-            saveHighScore();
-        }
+        highScore = std::max(highScore, score);  // 只更新内存，持久化由排行榜在对局结束后完成
         
         // 如果吃到特殊食物，启用或重置自动寻路
         if (food.isSpecial()) {
@@ -79,20 +112,145 @@ void Game::update() {
         }
         
         // 重新生成食物
-        food = Food();  // 创建新的食物对象
-        food.generateNew(WIDTH, HEIGHT, snake.getBody(), obstacles);
+        spawnFood();
         // 吃到食物后重新寻找路径
-        isFollowingPath = false;
-        currentPath.clear();
+        clearPath();
     }
 
     // 检查碰撞
     auto head = snake.getBody().front();
-    if (snake.checkCollision(WIDTH, HEIGHT) || 
-        snake.isCollidingWithSelf() || 
-        isObstacle(head.first, head.second)) {
+    if (snake.checkCollision(board.width, board.height)) {
+        outcome = Outcome::HIT_WALL;
+    } else if (snake.isCollidingWithSelf()) {
+        outcome = Outcome::HIT_SELF;
+    } else if (isObstacle(head.first, head.second)) {
+        outcome = Outcome::HIT_OBSTACLE;
+    }
+    if (outcome != Outcome::PLAYING && outcome != Outcome::WON) {
         snake.setAlive(false);
     }
+
+    recordRewind(ate);
+    requestPlan();
+}
+
+void Game::moveSnake() {
+    auto oldTail = snake.getBody().back();
+    snake.move();
+
+    // 尾部离开的格子若已无蛇身则重新空闲，蛇头进入的格子不再空闲
+    if (board.contains(oldTail.first, oldTail.second) && !snake.isOccupied(oldTail.first, oldTail.second)) {
+        foodCells.insert(board.index(oldTail.first, oldTail.second));
+        bodyBits.reset(oldTail.first, oldTail.second);
+    }
+    auto head = snake.getBody().front();
+    if (board.contains(head.first, head.second)) {
+        foodCells.erase(board.index(head.first, head.second));
+        bodyBits.set(head.first, head.second);
+    }
+}
+
+void Game::spawnFood() {
+    food = Food();  // 创建新的食物对象
+    if (!food.generateNew(board.width, foodCells, rng)) {
+        // 没有空闲格子可放食物：棋盘已满
+        outcome = Outcome::WON;
+    }
+}
+
+void Game::rebuildCellIndex() {
+    std::fill(obstacleGrid.begin(), obstacleGrid.end(), 0);
+    for (const auto& obstacle : obstacles) {
+        obstacleGrid[board.index(obstacle.first, obstacle.second)] = 1;
+    }
+
+    bodyBits.clear();
+    for (const auto& segment : snake.getBody()) {
+        if (board.contains(segment.first, segment.second)) {
+            bodyBits.set(segment.first, segment.second);
+        }
+    }
+
+    // 食物只出现在边缘以内的格子
+    foodCells.clear();
+    for (int y = 0; y < board.height; ++y) {
+        for (int x = 0; x < board.width; ++x) {
+            int cell = board.index(x, y);
+            if (x < 1 || x > board.width - 2 || y < 1 || y > board.height - 2) {
+                foodCells.exclude(cell);
+            } else if (!obstacleGrid[cell] && !snake.isOccupied(x, y)) {
+                foodCells.insert(cell);
+            }
+        }
+    }
+}
+
+int Game::step(int ticks) {
+    int executed = 0;
+    while (executed < ticks && !paused && !isGameOver()) {
+        update();
+        ++executed;
+    }
+    return executed;
+}
+
+bool Game::submitDirection(Direction newDirection, std::uint64_t arrivalNs) {
+    // 与最后一个排队的方向比较（队列为空时与当前方向比较），
+    // 这样同一帧内的快速转弯（如 UP 再 LEFT）会依次生效而不是被 180 度检查误判
+    Direction last = queuedInputs > 0 ? inputQueue[queuedInputs - 1].direction : snake.getDirection();
+    if (queuedInputs == MAX_QUEUED_INPUTS || newDirection == last || isOpposite(newDirection, last)) {
+        return false;
+    }
+    inputQueue[queuedInputs++] = {newDirection, arrivalNs != 0 ? arrivalNs : steadyClockNs()};
+    return true;
+}
+
+void Game::applyQueuedInput() {
+    QueuedInput input = inputQueue[0];
+    std::copy(inputQueue + 1, inputQueue + queuedInputs, inputQueue);
+    --queuedInputs;
+
+    changeDirection(input.direction);
+    inputLatency.record(steadyClockNs() - input.arrivalNs);
+}
+
+void Game::changeDirection(Direction newDirection) {
+    inputLog.push_back({tickCount, ReplayEvent::Kind::DIRECTION, static_cast<std::uint8_t>(newDirection)});
+    snake.changeDirection(newDirection);
+}
+
+void Game::setDifficulty(Difficulty d) {
+    inputLog.push_back({tickCount, ReplayEvent::Kind::DIFFICULTY, static_cast<std::uint8_t>(d)});
+    difficulty = d;
+    generateObstacles();
+    requestPlan();
+}
+
+void Game::applyReplayEvent(const ReplayEvent& event) {
+    switch (event.kind) {
+        case ReplayEvent::Kind::DIRECTION:
+            changeDirection(static_cast<Direction>(event.value));
+            break;
+        case ReplayEvent::Kind::DIFFICULTY:
+            setDifficulty(static_cast<Difficulty>(event.value));
+            break;
+    }
+}
+
+bool Game::getReplay(Replay& replay) const {
+    if (!replayable) return false;
+    replay.width = board.width;
+    replay.height = board.height;
+    replay.difficulty = static_cast<std::uint8_t>(initialDifficulty);
+    replay.alwaysAutoPath = alwaysAutoPath;
+    replay.strategy = static_cast<std::uint8_t>(autoPathStrategy);
+    replay.version = Replay::versionForRevision(autopilotRevision);
+    replay.seed = seed;
+    replay.events = inputLog;
+    replay.endTick = tickCount;
+    replay.endHash = getStateHash();
+    replay.endScore = score;
+    return true;
 }
 
 void Game::togglePause() {
@@ -100,15 +258,20 @@ void Game::togglePause() {
 }
 
 void Game::generateObstacles() {
+    // 移除旧障碍物，空出的格子重新可用
+    for (const auto& obstacle : obstacles) {
+        int cell = board.index(obstacle.first, obstacle.second);
+        obstacleGrid[cell] = 0;
+        if (!snake.isOccupied(obstacle.first, obstacle.second)) {
+            foodCells.insert(cell);
+        }
+    }
     obstacles.clear();
+    obstacleHash = 0;
     if (difficulty == Difficulty::EASY) {
         return;  // 简单难度没有障碍物
     }
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> disX(2, WIDTH - 3);
-    std::uniform_int_distribution<> disY(2, HEIGHT - 3);
 
     int numObstacles = (difficulty == Difficulty::NORMAL) ? 5 : 10;
     
@@ -117,15 +280,12 @@ void Game::generateObstacles() {
         bool valid;
         do {
             valid = true;
-            x = disX(gen);
-            y = disY(gen);
+            x = rng.range(2, board.width - 3);
+            y = rng.range(2, board.height - 3);
             
             // 检查是否与蛇身重叠
-            for (const auto& segment : snake.getBody()) {
-                if (segment.first == x && segment.second == y) {
-                    valid = false;
-                    break;
-                }
+            if (snake.isOccupied(x, y)) {
+                valid = false;
             }
             
             // 检查是否与食物重叠
@@ -134,128 +294,219 @@ void Game::generateObstacles() {
             }
             
             // 检查是否与其他障碍物重叠
-            for (const auto& obstacle : obstacles) {
-                if (obstacle.first == x && obstacle.second == y) {
-                    valid = false;
-                    break;
-                }
+            if (isObstacle(x, y)) {
+                valid = false;
             }
         } while (!valid);
         
         obstacles.push_back({x, y});
+        obstacleGrid[board.index(x, y)] = 1;
+        foodCells.erase(board.index(x, y));
     }
+    rehashObstacles();
 }
 
-bool Game::isObstacle(int x, int y) const {
+void Game::rehashObstacles() {
+    // 障碍物变化后回路需要重建，蛇身不再按新回路排列
+    cycleValid = false;
+    cycleRun = 0;
+    obstacleHash = 0;
+    obstacleBits.clear();
     for (const auto& obstacle : obstacles) {
-        if (obstacle.first == x && obstacle.second == y) {
-            return true;
-        }
+        obstacleHash ^= Zobrist::key(Zobrist::Feature::OBSTACLE,
+                                     board.index(obstacle.first, obstacle.second));
+        obstacleBits.set(obstacle.first, obstacle.second);
     }
-    return false;
 }
 
-void Game::saveHighScore() const {
-    std::ofstream file("highscore.txt");
-    if (file.is_open()) {
-        file << highScore;
-        file.close();
-    }
+std::uint64_t Game::getStateHash() const {
+    auto foodPos = food.getPosition();
+    Zobrist::Feature foodFeature = food.isSpecial() ? Zobrist::Feature::FOOD_SPECIAL : Zobrist::Feature::FOOD_NORMAL;
+    return snake.getHash() ^ obstacleHash ^
+           Zobrist::key(foodFeature, board.index(foodPos.first, foodPos.second));
 }
 
-void Game::loadHighScore() {
-    std::ifstream file("highscore.txt");
-    if (file.is_open()) {
-        file >> highScore;
-        file.close();
+bool Game::isObstacle(int x, int y) const {
+    if (!board.contains(x, y)) {
+        return false;
     }
+    return obstacleGrid[board.index(x, y)] != 0;
 }
 
-bool Game::saveGame(const std::string& filename) const {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) return false;
+void Game::captureState(GameState& state) const {
+    state.width = board.width;
+    state.height = board.height;
+    state.difficulty = static_cast<std::uint8_t>(difficulty);
+    state.initialDifficulty = static_cast<std::uint8_t>(initialDifficulty);
+    state.direction = static_cast<std::uint8_t>(snake.getDirection());
+    state.outcome = static_cast<std::uint8_t>(outcome);
+    state.foodType = static_cast<std::uint8_t>(food.getType());
+    state.paused = paused;
+    state.autoPathEnabled = autoPathEnabled;
+    state.alwaysAutoPath = alwaysAutoPath;
+    state.score = score;
+    state.highScore = highScore;
+    state.tickCount = tickCount;
+    state.autoPathStartTick = autoPathStartTick;
+    state.seed = seed;
+    state.rng = rng.getState();
+    state.food = food.getPosition();
+    auto body = snake.getBody();
+    state.body.assign(body.begin(), body.end());
+    state.obstacles = obstacles;
+    state.path.clear();
+    if (isFollowingPath) {
+        for (auto it = pathSteps.rbegin(); it != pathSteps.rend(); ++it) {
+            state.path.push_back(static_cast<std::uint8_t>(*it));
+        }
+    }
+}
 
-    // 保存游戏状态
-    file.write(reinterpret_cast<const char*>(&score), sizeof(score));
-    file.write(reinterpret_cast<const char*>(&highScore), sizeof(highScore));
-    file.write(reinterpret_cast<const char*>(&difficulty), sizeof(difficulty));
+bool Game::restoreState(const GameState& state) {
+    if (!applyState(state)) return false;
+    // 换成了另一条时间线，之前的历史不再能回退
+    rewindBuffer.clear();
+    recordRewind(false);
+    return true;
+}
 
-    // 保存蛇的状态
-    const auto& body = snake.getBody();
-    size_t bodySize = body.size();
-    file.write(reinterpret_cast<const char*>(&bodySize), sizeof(bodySize));
-    for (const auto& segment : body) {
-        file.write(reinterpret_cast<const char*>(&segment.first), sizeof(segment.first));
-        file.write(reinterpret_cast<const char*>(&segment.second), sizeof(segment.second));
+bool Game::applyState(const GameState& state) {
+    // 先整体校验，失败时保持当前对局不变
+    if (state.width != board.width || state.height != board.height) return false;
+    if (state.difficulty > static_cast<std::uint8_t>(Difficulty::HARD) ||
+        state.initialDifficulty > static_cast<std::uint8_t>(Difficulty::HARD) ||
+        state.direction > static_cast<std::uint8_t>(Direction::RIGHT) ||
+        state.outcome > static_cast<std::uint8_t>(Outcome::HIT_OBSTACLE) ||
+        state.foodType > static_cast<std::uint8_t>(Food::Type::SPECIAL) ||
+        state.body.empty() || !board.contains(state.food.first, state.food.second)) {
+        return false;
+    }
+    // 撞墙结束时蛇头停在棋盘外紧邻边界的一格，其余各节都在棋盘内
+    for (std::size_t i = 0; i < state.body.size(); ++i) {
+        const auto& segment = state.body[i];
+        if (board.contains(segment.first, segment.second)) continue;
+        if (i != 0 || state.outcome != static_cast<std::uint8_t>(Outcome::HIT_WALL)) return false;
+        int outX = segment.first < 0 ? -segment.first : std::max(0, segment.first - board.width + 1);
+        int outY = segment.second < 0 ? -segment.second : std::max(0, segment.second - board.height + 1);
+        if (outX + outY != 1) return false;
+    }
+    // 相邻两节须是相邻格子；蛇尾可以有若干节与前一节重合（待长出的节），此后不能再分开。
+    // 蛇身的增量维护和紧凑打包（PackedBody）都依赖这一点
+    bool inTailRepeat = false;
+    for (std::size_t i = 1; i < state.body.size(); ++i) {
+        int distance = std::abs(state.body[i].first - state.body[i - 1].first) +
+                       std::abs(state.body[i].second - state.body[i - 1].second);
+        if (distance == 0) {
+            inTailRepeat = true;
+        } else if (distance != 1 || inTailRepeat) {
+            return false;
+        }
+    }
+    for (const auto& obstacle : state.obstacles) {
+        if (!board.contains(obstacle.first, obstacle.second)) return false;
+    }
+    for (std::uint8_t dir : state.path) {
+        if (dir > static_cast<std::uint8_t>(Direction::RIGHT)) return false;
     }
 
-    // 保存食物位置
-    auto foodPos = food.getPosition();
-    file.write(reinterpret_cast<const char*>(&foodPos.first), sizeof(foodPos.first));
-    file.write(reinterpret_cast<const char*>(&foodPos.second), sizeof(foodPos.second));
+    snake.setBody(state.body);
+    snake.setDirection(static_cast<Direction>(state.direction));
+    outcome = static_cast<Outcome>(state.outcome);
+    snake.setAlive(outcome == Outcome::PLAYING || outcome == Outcome::WON);
+    obstacles = state.obstacles;
+    rehashObstacles();
+    rebuildCellIndex();
+    food.place(state.food, static_cast<Food::Type>(state.foodType));
 
-    // 保存障碍物
-    size_t obstacleSize = obstacles.size();
-    file.write(reinterpret_cast<const char*>(&obstacleSize), sizeof(obstacleSize));
-    for (const auto& obstacle : obstacles) {
-        file.write(reinterpret_cast<const char*>(&obstacle.first), sizeof(obstacle.first));
-        file.write(reinterpret_cast<const char*>(&obstacle.second), sizeof(obstacle.second));
+    difficulty = static_cast<Difficulty>(state.difficulty);
+    initialDifficulty = static_cast<Difficulty>(state.initialDifficulty);
+    paused = state.paused;
+    autoPathEnabled = state.autoPathEnabled;
+    alwaysAutoPath = state.alwaysAutoPath;
+    score = state.score;
+    highScore = std::max(highScore, static_cast<int>(state.highScore));
+    tickCount = state.tickCount;
+    autoPathStartTick = state.autoPathStartTick;
+    seed = state.seed;
+    rng.setState(state.rng);
+    queuedInputs = 0;
+    plannedPath.clear();
+    for (std::uint8_t dir : state.path) {
+        plannedPath.push_back(static_cast<Direction>(dir));
     }
+    clearPath();
+    pushPath(plannedPath, 0);
 
+    // 读档后的局面不再能从种子重放
+    inputLog.clear();
+    replayable = false;
+    requestPlan();
     return true;
 }
 
-bool Game::loadGame(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) return false;
-
-    // 读取游戏状态
-    file.read(reinterpret_cast<char*>(&score), sizeof(score));
-    file.read(reinterpret_cast<char*>(&highScore), sizeof(highScore));
-    file.read(reinterpret_cast<char*>(&difficulty), sizeof(difficulty));
-
-    // 读取蛇的状态
-    size_t bodySize;
-    file.read(reinterpret_cast<char*>(&bodySize), sizeof(bodySize));
-    std::list<std::pair<int, int>> newBody;
-    for (size_t i = 0; i < bodySize; ++i) {
-        int x, y;
-        file.read(reinterpret_cast<char*>(&x), sizeof(x));
-        file.read(reinterpret_cast<char*>(&y), sizeof(y));
-        newBody.push_back({x, y});
-    }
+void Game::recordRewind(bool grew) {
+    if (!rewindBuffer.isEnabled()) return;
+    auto body = snake.getBody();
+    RewindFrame frame;
+    frame.tick = tickCount;
+    frame.head = body.front();
+    frame.neck = body.size() > 1 ? body[1] : body.front();
+    frame.length = static_cast<std::uint32_t>(body.size());
+    frame.grew = grew;
+    frame.food = food.getPosition();
+    frame.foodType = static_cast<std::uint8_t>(food.getType());
+    frame.score = score;
+    frame.highScore = highScore;
+    frame.direction = static_cast<std::uint8_t>(snake.getDirection());
+    frame.outcome = static_cast<std::uint8_t>(outcome);
+    frame.difficulty = static_cast<std::uint8_t>(difficulty);
+    frame.paused = paused;
+    frame.autoPathEnabled = autoPathEnabled;
+    frame.autoPathStartTick = autoPathStartTick;
+    frame.rng = rng.getState();
+    frame.obstacleHash = obstacleHash;
 
-    // 读取食物位置
-    int foodX, foodY;
-    file.read(reinterpret_cast<char*>(&foodX), sizeof(foodX));
-    file.read(reinterpret_cast<char*>(&foodY), sizeof(foodY));
-
-    // 读取障碍物
-    size_t obstacleSize;
-    file.read(reinterpret_cast<char*>(&obstacleSize), sizeof(obstacleSize));
-    obstacles.clear();
-    for (size_t i = 0; i < obstacleSize; ++i) {
-        int x, y;
-        file.read(reinterpret_cast<char*>(&x), sizeof(x));
-        file.read(reinterpret_cast<char*>(&y), sizeof(y));
-        obstacles.push_back({x, y});
+    if (rewindBuffer.needsKeyframe(frame)) {
+        GameState state;
+        captureState(state);
+        rewindBuffer.addKeyframe(state, frame);
+    } else {
+        rewindBuffer.addDelta(frame);
     }
+}
 
-    // 更新游戏状态
-    snake = Snake(newBody.front().first, newBody.front().second);
-    for (auto it = ++newBody.begin(); it != newBody.end(); ++it) {
-        snake.grow();
-    }
-    food = Food();
-    food.generateNew(WIDTH, HEIGHT, snake.getBody(), obstacles);
+std::uint64_t Game::getRewindableTicks() const {
+    return rewindBuffer.empty() ? 0 : tickCount - std::min(tickCount, rewindBuffer.getOldestTick());
+}
 
+bool Game::rewind(std::uint64_t ticks) {
+    if (rewindBuffer.empty() || ticks == 0) return false;
+    std::uint64_t target = tickCount - std::min(ticks, getRewindableTicks());
+    GameState state;
+    if (!rewindBuffer.stateAt(target, state)) return false;
+    state.paused = paused;  // 暂停中回退时保持暂停
+    if (!applyState(state)) return false;
+    rewindBuffer.truncateAfter(target);
+    rankable = false;  // 回退后重新打出的结局不再计入排行榜，避免同一局提交多条成绩
     return true;
 }
 
+bool Game::saveGame(const std::string& filename) const {
+    GameState state;
+    captureState(state);
+    return SaveFile::write(filename, state);
+}
+
+bool Game::loadGame(const std::string& filename) {
+    GameState state;
+    return SaveFile::read(filename, state) && restoreState(state);
+}
+
 void Game::enableAutoPath() {
     autoPathEnabled = true;
-    autoPathStartTime = std::chrono::steady_clock::now();
-    findPathToFood();
+    autoPathStartTick = tickCount;
+    // 路径在下一帧按新状态重新规划
+    clearPath();
 }
 
 void Game::disableAutoPath() {
@@ -263,156 +514,576 @@ void Game::disableAutoPath() {
 }
 
 bool Game::isAutoPathActive() const {
-    if (!autoPathEnabled) return false;
-    auto now = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - autoPathStartTime);
-    return duration.count() < AUTO_PATH_DURATION;
+    return alwaysAutoPath || getAutoPathRemainingTicks() > 0;
 }
 
-bool Game::isValidPosition(int x, int y, const std::list<std::pair<int, int>>& currentBody) const {
+int Game::getAutoPathRemainingTicks() const {
+    if (!autoPathEnabled) return 0;
+    std::uint64_t elapsed = tickCount - autoPathStartTick;
+    if (elapsed >= static_cast<std::uint64_t>(AUTO_PATH_TICKS)) return 0;
+    return AUTO_PATH_TICKS - static_cast<int>(elapsed);
+}
+
+int Game::getAutoPathRemainingSeconds() const {
+    // 向上取整，保证剩余不足一秒时仍显示 1s
+    int remainingMs = getAutoPathRemainingTicks() * TICK_INTERVAL_MS;
+    return (remainingMs + 999) / 1000;
+}
+
+bool Game::isValidPosition(int x, int y) const {
     // 检查是否在边界内
-    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
+    if (!board.contains(x, y)) {
         return false;
     }
-    
+
     // 检查是否是障碍物
     if (isObstacle(x, y)) {
         return false;
     }
-    
-    // 检查是否与蛇身重叠（除了尾部，因为蛇移动时尾部会离开）
-    auto tail = currentBody.back();
-    for (auto it = currentBody.begin(); it != --currentBody.end(); ++it) {
-        if (it->first == x && it->second == y) {
-            return false;
-        }
+
+    // 检查是否与蛇身重叠（尾部在移动时会离开，只要该格子没有其他蛇身重叠即可进入）
+    int occupied = snake.occupancyAt(x, y);
+    if (occupied == 0) {
+        return true;
     }
-    
-    return true;
+    return occupied == 1 && snake.getBody().back() == std::make_pair(x, y);
 }
 
 Direction Game::findPathToFood() {
     auto head = snake.getBody().front();
     auto foodPos = food.getPosition();
-    auto currentBody = snake.getBody();
+
+    // 同一局面之前规划过，直接复用缓存的第一步；键冲突时缓存的方向可能不适用于当前局面，
+    // 校验不通过就删除该条目重新搜索
+    std::uint64_t stateHash = getStateHash();
+    TranspositionTable::Entry cached;
+    if (transpositionTable.probe(stateHash, cached)) {
+        if (isCachedMoveSafe(cached.getMove())) {
+            clearPath();
+            return cached.getMove();
+        }
+        transpositionTable.remove(stateHash);
+    }
+
+    bool found;
+    if (planner) {
+        // 后台规划器已在上一帧结束时开始搜索本局面，这里只取已完成的结果；
+        // 来不及时不等待，本帧走备选方向（结果取决于时序，对局不再可重放）
+        if (!planner->take(stateHash, planResult)) {
+            ++latePlans;
+            replayable = false;
+            clearPath();
+            return findFallbackDirection();
+        }
+        found = planResult.found;
+        std::swap(plannedPath, planResult.path);
+        planLatency.record(planResult.elapsedNs);
+    } else {
+        // 按时间感知的网格 BFS 搜索：每节蛇身标记为其离开所在格子的帧数，
+        // 第 step 步只要 step 不小于该标记即可进入，无需在搜索节点中复制蛇身，
+        // 得到的路径沿途每一步都精确有效
+        std::uint64_t start = steadyClockNs();
+        labelReleaseTicks();
+        found = pathFinder.findPath(head, foodPos,
+            [this](int x, int y, int step) {
+                return !isObstacle(x, y) && step >= releaseTicks[board.index(x, y)];
+            }, plannedPath);
+        clearReleaseTicks();
+        planLatency.record(steadyClockNs() - start);
+    }
+
+    // 吃到食物后会被自己困住的路径不走，改用备选方向
+    if (found && !plannedPath.empty() && autopilotRevision >= 1 && !isPathSurvivable(plannedPath)) {
+        found = false;
+    }
+
+    if (found && !plannedPath.empty()) {
+        // 第一步立即执行，路径中只保留后续步骤
+        Direction firstDir = plannedPath.front();
+        transpositionTable.store(stateHash, static_cast<std::int32_t>(plannedPath.size()), firstDir, 1);
+        clearPath();
+        pushPath(plannedPath, 1);
+        return firstDir;
+    }
     
-    // 使用BFS寻找到食物的最短路径
-    struct State {
-        std::pair<int, int> pos;
-        std::list<std::pair<int, int>> body;
-        std::vector<Direction> path;  // 存储到达该状态的路径
-        
-        size_t hash() const {
-            // 只使用头部位置和身体的前几个部分来计算哈希值
-            size_t h = pos.first * 1000 + pos.second;
-            int count = 0;
-            for (const auto& segment : body) {
-                if (count >= 3) break;  // 只使用前3个身体部分
-                h = h * 31 + segment.first * 1000 + segment.second;
-                count++;
+    // 如果找不到路径，使用备选策略
+    clearPath();
+    return findFallbackDirection();
+}
+
+void Game::pushPath(const std::vector<Direction>& path, std::size_t first) {
+    // 从蛇头出发依次走 path，path[first] 起的各步倒序压在剩余路径之上
+    std::size_t base = pathSteps.size();
+    std::size_t count = path.size() > first ? path.size() - first : 0;
+    pathSteps.resize(base + count);
+    pathCells.resize(base + count);
+    std::pair<int, int> pos = snake.getBody().front();
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        pos = advance(pos, path[i]);
+        if (i < first) continue;
+        std::size_t slot = base + count - 1 - (i - first);
+        pathSteps[slot] = path[i];
+        pathCells[slot] = pos;
+        if (board.contains(pos.first, pos.second)) {
+            pathSlot[board.index(pos.first, pos.second)] = static_cast<int>(slot);
+        }
+    }
+    isFollowingPath = !pathSteps.empty();
+}
+
+void Game::clearPath() {
+    isFollowingPath = false;
+    pathSteps.clear();
+    pathCells.clear();
+}
+
+int Game::pathSlotAt(int x, int y) const {
+    int slot = pathSlot[board.index(x, y)];
+    if (slot < 0 || slot >= static_cast<int>(pathCells.size()) || pathCells[slot] != std::make_pair(x, y)) {
+        return -1;
+    }
+    return slot;
+}
+
+bool Game::repairPath() {
+    // 剩余路径第 k 步（下一步为 1）进入的格子位于 pathCells[size - k]。
+    // 绕行 d 步接上第 k 步的格子时要求 d >= k：之后各步都不早于原计划到达，
+    // 蛇身让出的格子只会更多，接上之后的剩余路径仍然精确有效。
+    // 绕行途中不经过剩余路径上的格子，避免与之后的路径重叠；搜索规模有上限，代价只取决于需要绕开的范围
+    int remaining = static_cast<int>(pathSteps.size());
+    auto head = snake.getBody().front();
+    labelReleaseTicks();
+    bool found = pathFinder.findDetour(head,
+        [this, remaining](int x, int y, int step) {
+            int slot = pathSlotAt(x, y);
+            return slot >= 0 && step >= remaining - slot &&
+                   !isObstacle(x, y) && step >= releaseTicks[board.index(x, y)];
+        },
+        [this](int x, int y, int step) {
+            return pathSlotAt(x, y) < 0 && !isObstacle(x, y) && step >= releaseTicks[board.index(x, y)];
+        }, plannedPath, MAX_REPAIR_NODES);
+    clearReleaseTicks();
+    if (!found) return false;
+
+    // 去掉被绕开的一段（含接回的格子），把绕行的各步倒序压回
+    std::pair<int, int> pos = head;
+    for (Direction dir : plannedPath) {
+        pos = advance(pos, dir);
+    }
+    std::size_t joinSlot = static_cast<std::size_t>(pathSlotAt(pos.first, pos.second));
+    pathSteps.resize(joinSlot);
+    pathCells.resize(joinSlot);
+    pushPath(plannedPath, 0);
+    return true;
+}
+
+void Game::requestPlan() {
+    if (!planner) return;
+    if (isGameOver() || !isAutoPathActive() ||
+        (autoPathStrategy == AutoPathStrategy::HAMILTON &&
+         (autopilotRevision >= 4 ||  // 修订 4 起回路策略只在本帧同步寻路
+          (isOnCycle(snake.getBody().front()) && (autopilotRevision >= 3 || isOnCycle(food.getPosition())))))) {
+        planner->cancel();
+        return;
+    }
+
+    // 下一帧会沿用现有路径或命中置换表时无需规划
+    if (isFollowingPath && !pathSteps.empty()) {
+        std::pair<int, int> nextPos = advance(snake.getBody().front(), pathSteps.back());
+        if (isValidPosition(nextPos.first, nextPos.second)) {
+            planner->cancel();
+            return;
+        }
+    }
+    std::uint64_t stateHash = getStateHash();
+    TranspositionTable::Entry cached;
+    if (transpositionTable.probe(stateHash, cached)) {
+        planner->cancel();
+        return;
+    }
+
+    planRequest.stateHash = stateHash;
+    planRequest.goal = food.getPosition();
+    planRequest.body.clear();
+    for (const auto& segment : snake.getBody()) {
+        planRequest.body.push_back(segment);
+    }
+    planRequest.obstacleHash = obstacleHash;
+    planRequest.obstacles = obstacles;
+    planner->request(planRequest);
+}
+
+bool Game::isOnCycle(std::pair<int, int> pos) {
+    if (!cycleValid) {
+        cycle.build(obstacleGrid, autopilotRevision >= 3);  // 修订 3 起把回路旁成对的空闲格子并入回路
+        cycleValid = true;
+    }
+    return board.contains(pos.first, pos.second) && cycle.contains(pos.first, pos.second);
+}
+
+bool Game::findCycleDirection(Direction& dir) {
+    auto body = snake.getBody();
+    auto head = body.front();
+    auto tail = body.back();
+    auto foodPos = food.getPosition();
+    if (autopilotRevision >= 4) {
+        // 修订 4 起按蛇身的实际位置判断是否按回路顺序排列；交接路径走完之前照走，
+        // 蛇身打乱时先回到回路上
+        if (followCyclePath(dir)) return true;
+        if (!isCycleOrdered()) {
+            cycleRun = 0;
+            return findCycleRejoin(dir);
+        }
+    } else if (autopilotRevision >= 3) {
+        // 修订 3 起食物不在回路上时不再改用贪心寻路（蛇身会因此打乱，之后沿回路走也不再安全），
+        // 而是经回路旁的格子绕行一步吃到，够不到时沿回路兜圈
+        if (!isOnCycle(head)) return findDetourExit(dir);
+    } else if (!isOnCycle(head) || !isOnCycle(foodPos)) {
+        return false;
+    }
+    bool foodOnCycle = isOnCycle(foodPos);
+
+    // 蛇身按回路顺序排列时，回路上从蛇头到蛇尾之间的格子都是空的：
+    // 只要落点仍在这一段内并与蛇尾留出余量，跳过去就不会截断蛇尾，之后沿回路前进总是安全的
+    int length = static_cast<int>(body.size());
+    int bestDistance = 0;
+    bool ordered = (autopilotRevision >= 4 || cycleRun >= length) && isOnCycle(tail);
+    std::pair<int, int> entry;
+    std::pair<int, int> exit;
+    bool detour = !foodOnCycle && findDetour(foodPos, entry, exit);
+    if (detour && ordered && head == entry && length > 1 && (autopilotRevision < 4 || length < cycle.length())) {
+        // 绕行的两步相当于从 entry 抄近路到 exit，同样不能越过蛇尾；修订 4 起吃到后蛇身还要放得进回路
+        int tailDistance = cycle.distance(head, tail);
+        if (cycle.distance(entry, exit) <= tailDistance - SHORTCUT_MARGIN) {
+            for (Direction candidate : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+                if (advance(head, candidate) == foodPos) dir = candidate;
             }
-            return h;
+            ++cycleRun;
+            return true;
         }
-    };
-    
-    std::queue<State> q;
-    std::unordered_set<size_t> visited;
-    
-    // 初始状态
-    State initialState = {head, currentBody, {}};
-    q.push(initialState);
-    visited.insert(initialState.hash());
-    
-    while (!q.empty()) {
-        auto current = q.front();
-        q.pop();
-        
-        if (current.pos == foodPos) {
-            // 验证整个路径是否有效
-            bool pathValid = true;
-            std::list<std::pair<int, int>> simulatedBody = currentBody;
-            
-            for (const auto& dir : current.path) {
-                auto nextPos = simulatedBody.front();
-                switch (dir) {
-                    case Direction::UP: nextPos.second--; break;
-                    case Direction::DOWN: nextPos.second++; break;
-                    case Direction::LEFT: nextPos.first--; break;
-                    case Direction::RIGHT: nextPos.first++; break;
-                    default: break;
-                }
-                
-                if (!isValidPosition(nextPos.first, nextPos.second, simulatedBody)) {
-                    pathValid = false;
-                    break;
-                }
-                
-                simulatedBody.pop_back();
-                simulatedBody.push_front(nextPos);
+    }
+    // 修订 4 起回路上够不到的食物（回路外且不能绕行，或到了入口蛇尾余量不够）交给寻路：
+    // 路径要通过存活检查，吃到后还要能从食物旁回到回路上；找不到这样的路径时沿回路兜圈
+    if (autopilotRevision >= 4 && !foodOnCycle && (!detour || head == entry) && planCycleHandover()) {
+        cycleRun = 0;
+        return followCyclePath(dir);
+    }
+    if (ordered && length * 2 < cycle.length()) {
+        int tailDistance = length > 1 ? cycle.distance(head, tail) : cycle.length();
+        int limit = tailDistance - SHORTCUT_MARGIN;
+        // 不越过食物（或绕行的入口）
+        if (foodOnCycle || detour) {
+            int foodDistance = cycle.distance(head, foodOnCycle ? foodPos : entry);
+            if (foodDistance < tailDistance) {
+                limit = std::min(limit, foodDistance);
             }
-            
-            if (pathValid) {
-                // 只有在整个路径都有效时才保存
-                currentPath = current.path;
-                isFollowingPath = true;
-                return current.path.empty() ? snake.getDirection() : current.path[0];
+        }
+        // 修订 4 起抄近路后还要给绕行留出余量，否则蛇头一直紧跟蛇尾，到了入口总是绕不过去
+        if (autopilotRevision >= 4 && detour) {
+            limit = std::min(limit, tailDistance - SHORTCUT_MARGIN - cycle.distance(entry, exit));
+        }
+        static const Direction DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+        for (Direction candidate : DIRECTIONS) {
+            if (length > 1 && isOpposite(candidate, snake.getDirection())) continue;
+            std::pair<int, int> target = advance(head, candidate);
+            if (!isOnCycle(target)) continue;
+            int distance = cycle.distance(head, target);
+            if (distance > bestDistance && distance <= limit && isValidPosition(target.first, target.second)) {
+                bestDistance = distance;
+                dir = candidate;
             }
-            // 如果路径无效，继续搜索
-            continue;
         }
-        
-        // 尝试所有可能的移动方向
-        std::vector<std::pair<Direction, std::pair<int, int>>> moves = {
-            {Direction::UP, {current.pos.first, current.pos.second - 1}},
-            {Direction::DOWN, {current.pos.first, current.pos.second + 1}},
-            {Direction::LEFT, {current.pos.first - 1, current.pos.second}},
-            {Direction::RIGHT, {current.pos.first + 1, current.pos.second}}
-        };
-        
-        // 根据食物位置调整移动优先级
-        int dx = foodPos.first - current.pos.first;
-        int dy = foodPos.second - current.pos.second;
-        
-        // 根据距离食物的方向调整优先级
-        std::sort(moves.begin(), moves.end(), 
-            [dx, dy](const std::pair<Direction, std::pair<int, int>>& a, 
-                    const std::pair<Direction, std::pair<int, int>>& b) {
-                int distA = std::abs(a.second.first - dx) + std::abs(a.second.second - dy);
-                int distB = std::abs(b.second.first - dx) + std::abs(b.second.second - dy);
-                return distA < distB;
-            });
-        
-        for (const auto& move : moves) {
-            const Direction& dir = move.first;
-            const std::pair<int, int>& next = move.second;
-            
-            if (isValidPosition(next.first, next.second, current.body)) {
-                std::list<std::pair<int, int>> newBody = current.body;
-                newBody.pop_back();
-                newBody.push_front(next);
-                
-                State newState = {next, newBody, current.path};
-                newState.path.push_back(dir);
-                
-                size_t stateHash = newState.hash();
-                if (visited.find(stateHash) == visited.end()) {
-                    visited.insert(stateHash);
-                    q.push(newState);
-                }
+    }
+
+    if (bestDistance == 0) {
+        // 没有可抄的近路：沿回路走一步
+        Direction along = cycle.nextAt(head.first, head.second);
+        std::pair<int, int> target = advance(head, along);
+        if ((length > 1 && isOpposite(along, snake.getDirection())) || !isValidPosition(target.first, target.second)) {
+            if (autopilotRevision < 4) return false;
+            cycleRun = 0;
+            dir = findFallbackDirection();
+            return true;
+        }
+        dir = along;
+    }
+    ++cycleRun;
+    return true;
+}
+
+bool Game::findDetour(std::pair<int, int> cell, std::pair<int, int>& entry, std::pair<int, int>& exit) {
+    // 回路旁的格子至少与两个回路格子相邻时可以绕行：从回路上较早的一格进入，从之后最近的一格离开
+    std::pair<int, int> neighbors[4];
+    int count = 0;
+    for (Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+        std::pair<int, int> next = advance(cell, dir);
+        if (isOnCycle(next)) neighbors[count++] = next;
+    }
+    int best = -1;
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < count; ++j) {
+            if (i == j) continue;
+            int skipped = cycle.distance(neighbors[i], neighbors[j]);
+            if (best < 0 || skipped < best) {
+                best = skipped;
+                entry = neighbors[i];
+                exit = neighbors[j];
             }
         }
     }
-    
-    // 如果找不到路径，使用备选策略
-    isFollowingPath = false;
-    currentPath.clear();
-    return findFallbackDirection();
+    return best > 0;
+}
+
+bool Game::findDetourExit(Direction& dir) {
+    // 蛇头在绕行的格子上：回到回路上离蛇颈之后最近的空闲格子
+    auto body = snake.getBody();
+    if (body.size() < 2 || cycleRun == 0 || !isOnCycle(body[1])) return false;
+    auto head = body.front();
+    int best = -1;
+    for (Direction candidate : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+        std::pair<int, int> target = advance(head, candidate);
+        if (target == body[1] || !isOnCycle(target) || !isValidPosition(target.first, target.second)) continue;
+        int distance = cycle.distance(body[1], target);
+        if (best < 0 || distance < best) {
+            best = distance;
+            dir = candidate;
+        }
+    }
+    if (best < 0) return false;
+    ++cycleRun;
+    return true;
+}
+
+bool Game::isCycleOrdered() {
+    // 蛇身按回路顺序排列：蛇头和蛇尾都在回路上，回路上的第 i 节沿回路走到蛇头的步数减去 i 从蛇头往后不减。
+    // 沿回路前进和抄近路都保持这一性质，此时回路上从蛇头到蛇尾之间的格子都是空的。
+    // 回路外的节（绕行经过的格子）不会被沿回路前进的蛇头进入，跳过。
+    // 逐节检查是 O(n) 的：cycleRun 不为 0 时上一帧已确认有序并按回路走法走了一步，顺序不变，只检查蛇尾
+    auto body = snake.getBody();
+    auto head = body.front();
+    auto tail = body.back();
+    if (!isOnCycle(head) || !isOnCycle(tail)) return false;
+    int last = static_cast<int>(body.size()) - 1;
+    if (cycleRun == 0) {
+        int previous = 0;
+        for (int i = 1; i <= last; ++i) {
+            if (!isOnCycle(body[i]) || body[i] == body[i - 1]) continue;
+            int key = cycle.distance(body[i], head) - i;
+            if (key < previous) return false;
+            previous = key;
+        }
+    }
+    // 蛇尾有 repeats 节待长出的重叠节时要再过 repeats + 1 帧才空出，蛇头沿回路走到那里之前不能追上
+    int repeats = 0;
+    while (repeats < last && body[last - repeats - 1] == tail) {
+        ++repeats;
+    }
+    return last == 0 || cycle.distance(head, tail) > repeats;
+}
+
+bool Game::isCycleWalkSafe(std::pair<int, int> start, int step, int length) {
+    // 第 step 步进入 start 后沿回路再走，直到走过的格子容得下整条蛇：
+    // 每一步进入的格子届时都已空出（releaseTicks 须已标记），途经食物时之后的蛇身多停一帧。
+    // 走完后蛇身恰好排在走过的一段回路上
+    auto foodPos = food.getPosition();
+    std::pair<int, int> pos = start;
+    int growth = 0;
+    for (int k = 0; k < length + growth; ++k, ++step) {
+        if (length + growth > cycle.length() || !isOnCycle(pos) ||
+            step < releaseTicks[board.index(pos.first, pos.second)] + growth) {
+            return false;
+        }
+        if (pos == foodPos) ++growth;
+        pos = advance(pos, cycle.nextAt(pos.first, pos.second));
+    }
+    return true;
+}
+
+bool Game::findCycleRejoin(Direction& dir) {
+    // 蛇身没有按回路顺序排列（交接路径刚吃到食物、开局或刚长出一节）：只进入之后能沿回路走完一整条蛇长的格子，
+    // 优先沿回路前进，其次接在蛇颈之后最近的格子；旁边没有这样的格子时用有界搜索找一条过去的路
+    auto body = snake.getBody();
+    auto head = body.front();
+    int length = static_cast<int>(body.size());
+    labelReleaseTicks();
+    int best = -1;
+    for (Direction candidate : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+        if (length > 1 && isOpposite(candidate, snake.getDirection())) continue;
+        std::pair<int, int> target = advance(head, candidate);
+        if (!isOnCycle(target) || !isValidPosition(target.first, target.second) || !isCycleWalkSafe(target, 1, length)) {
+            continue;
+        }
+        int rank = cycle.length();
+        if (isOnCycle(head) && candidate == cycle.nextAt(head.first, head.second)) {
+            rank = 0;
+        } else if (length > 1 && isOnCycle(body[1])) {
+            rank = cycle.distance(body[1], target);
+        }
+        if (target == food.getPosition()) {
+            rank += cycle.length();  // 吃到后新生成的食物可能又挡在要走的回路上，不急着吃
+        }
+        if (best < 0 || rank < best) {
+            best = rank;
+            dir = candidate;
+        }
+    }
+    if (best >= 0) {
+        clearReleaseTicks();
+        return true;
+    }
+
+    bool found = pathFinder.findDetour(head,
+        [this, length](int x, int y, int step) {
+            return isOnCycle({x, y}) && step >= releaseTicks[board.index(x, y)] && isCycleWalkSafe({x, y}, step, length);
+        },
+        [this](int x, int y, int step) {
+            return !isObstacle(x, y) && step >= releaseTicks[board.index(x, y)] && food.getPosition() != std::make_pair(x, y);
+        }, plannedPath, MAX_REPAIR_NODES);
+    clearReleaseTicks();
+    if (found) {
+        clearPath();
+        pushPath(plannedPath, 0);
+        return followCyclePath(dir);
+    }
+    // 回不到回路时先走进入后还能到达蛇尾的一步，等蛇尾让出格子：沿回路前进优先，其次回路上的格子，
+    // 不去追食物（吃到后更难回到回路上）；都不行时用备选方向
+    best = -1;
+    for (Direction candidate : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+        if (length > 1 && isOpposite(candidate, snake.getDirection())) continue;
+        std::pair<int, int> target = advance(head, candidate);
+        bool reachesTail = false;
+        if (!isValidPosition(target.first, target.second) || (regionAfterMove(target, reachesTail), !reachesTail)) {
+            continue;
+        }
+        int rank = 3;
+        if (isOnCycle(head) && candidate == cycle.nextAt(head.first, head.second)) {
+            rank = 0;
+        } else if (isOnCycle(target)) {
+            rank = 1;
+        } else if (target != food.getPosition()) {
+            rank = 2;
+        }
+        if (best < 0 || rank < best) {
+            best = rank;
+            dir = candidate;
+        }
+    }
+    if (best < 0) {
+        dir = findFallbackDirection();
+    }
+    return true;
+}
+
+bool Game::planCycleHandover() {
+    // 时间感知 BFS 到食物，再检查吃到后的局面：食物旁要有一个回路格子能接着沿回路走完一整条蛇长。
+    // 吃到后新生成的食物常常就在旁边，按紧接着再吃一个估计：蛇长 n + 2，路径上第 p 步进入的格子在第 p + n + 2 步空出，
+    // 原蛇身在吃到之后才离开的格子多停两帧
+    auto body = snake.getBody();
+    auto head = body.front();
+    auto foodPos = food.getPosition();
+    labelReleaseTicks();
+    bool found = pathFinder.findPath(head, foodPos,
+        [this](int x, int y, int step) {
+            return !isObstacle(x, y) && step >= releaseTicks[board.index(x, y)];
+        }, plannedPath);
+    clearReleaseTicks();
+    if (!found || plannedPath.empty() || !isPathSurvivable(plannedPath)) return false;
+
+    int length = static_cast<int>(body.size());
+    int steps = static_cast<int>(plannedPath.size());
+    for (int i = 0; i < length; ++i) {
+        if (!board.contains(body[i].first, body[i].second)) continue;
+        int release = length - i > steps ? length - i + 2 : length - i;
+        int& label = releaseTicks[board.index(body[i].first, body[i].second)];
+        label = std::max(label, release);
+    }
+    std::pair<int, int> pos = head;
+    for (int p = 1; p <= steps; ++p) {
+        pos = advance(pos, plannedPath[p - 1]);
+        int& label = releaseTicks[board.index(pos.first, pos.second)];
+        label = std::max(label, p + length + 2);
+    }
+    bool rejoins = false;
+    for (Direction candidate : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+        std::pair<int, int> target = advance(foodPos, candidate);
+        if (isOnCycle(target) && isCycleWalkSafe(target, steps + 1, length + 2)) {
+            rejoins = true;
+            break;
+        }
+    }
+    clearReleaseTicks();
+    pos = head;
+    for (Direction step : plannedPath) {
+        pos = advance(pos, step);
+        releaseTicks[board.index(pos.first, pos.second)] = 0;
+    }
+    if (!rejoins) return false;
+
+    clearPath();
+    pushPath(plannedPath, 0);
+    return true;
+}
+
+bool Game::followCyclePath(Direction& dir) {
+    // 交接路径和回到回路的路径按时间感知搜索得到，下一步仍是记录的格子且可以进入时照走
+    if (!isFollowingPath || pathSteps.empty()) return false;
+    std::pair<int, int> next = advance(snake.getBody().front(), pathSteps.back());
+    if (next != pathCells.back() || !isValidPosition(next.first, next.second)) {
+        clearPath();
+        return false;
+    }
+    dir = pathSteps.back();
+    pathSteps.pop_back();
+    pathCells.pop_back();
+    cycleRun = 0;
+    return true;
+}
+
+int Game::getUncoveredCycleCells() {
+    isOnCycle(snake.getBody().front());  // 按需重建回路
+    return cycle.uncovered();
+}
+
+std::pair<int, int> Game::advance(std::pair<int, int> pos, Direction dir) {
+    switch (dir) {
+        case Direction::UP: pos.second--; break;
+        case Direction::DOWN: pos.second++; break;
+        case Direction::LEFT: pos.first--; break;
+        case Direction::RIGHT: pos.first++; break;
+        default: break;
+    }
+    return pos;
+}
+
+void Game::labelReleaseTicks() {
+    PathFinder::labelReleaseTicks(snake.getBody(), board.width, board.height, releaseTicks);
+}
+
+void Game::clearReleaseTicks() {
+    PathFinder::clearReleaseTicks(snake.getBody(), board.width, board.height, releaseTicks);
+}
+
+bool Game::isCachedMoveSafe(Direction move) {
+    auto body = snake.getBody();
+    Direction current = snake.getDirection();
+    bool reverses = (current == Direction::UP && move == Direction::DOWN) ||
+                    (current == Direction::DOWN && move == Direction::UP) ||
+                    (current == Direction::LEFT && move == Direction::RIGHT) ||
+                    (current == Direction::RIGHT && move == Direction::LEFT);
+    if (body.size() > 1 && reverses) return false;
+
+    std::pair<int, int> next = advance(body.front(), move);
+    if (!isValidPosition(next.first, next.second)) return false;
+    if (autopilotRevision < 1) return true;
+    // 与搜索结果的存活检查对应：进入后蛇头要么能到达蛇尾，要么所在区域容得下整条蛇
+    bool reachesTail = false;
+    int region = regionAfterMove(next, reachesTail);
+    return reachesTail || region >= static_cast<int>(body.size());
 }
 
 Direction Game::findFallbackDirection() {
     auto head = snake.getBody().front();
     auto foodPos = food.getPosition();
-    auto currentBody = snake.getBody();
     
     int dx = foodPos.first - head.first;
     int dy = foodPos.second - head.second;
@@ -465,13 +1136,73 @@ Direction Game::findFallbackDirection() {
         }
     }
     
+    // 按优先顺序取第一个进入后仍能到达蛇尾、或区域容得下整条蛇的方向；都不满足时取区域最大的方向
+    int length = static_cast<int>(snake.getBody().size());
+    int bestRegion = -1;
+    Direction bestDir = snake.getDirection();
     for (const auto& move : fallbackMoves) {
         const Direction& dir = move.first;
         const std::pair<int, int>& pos = move.second;
-        if (isValidPosition(pos.first, pos.second, currentBody)) {
-            return dir;
+        if (isValidPosition(pos.first, pos.second)) {
+            if (autopilotRevision < 1) {
+                return dir;
+            }
+            bool reachesTail = false;
+            int region = regionAfterMove(pos, reachesTail);
+            if (reachesTail || region >= length) {
+                return dir;
+            }
+            if (region > bestRegion) {
+                bestRegion = region;
+                bestDir = dir;
+            }
         }
     }
     
-    return snake.getDirection();
+    return bestDir;
+}
+
+bool Game::isPathSurvivable(const std::vector<Direction>& path) {
+    // 走完 path（k 步）吃到食物后的蛇身：path 经过的最后 n 个格子加原蛇身的前 n - k 节，
+    // 吃到食物时蛇尾不动。原蛇身后 k 节空出，其余格子沿用当前占据情况
+    auto body = snake.getBody();
+    int length = static_cast<int>(body.size());
+    int steps = static_cast<int>(path.size());
+    freeBits.assignFree(obstacleBits, bodyBits);
+    for (int i = std::max(0, length - steps); i < length; ++i) {
+        if (board.contains(body[i].first, body[i].second)) {
+            freeBits.set(body[i].first, body[i].second);
+        }
+    }
+
+    std::pair<int, int> pos = body.front();
+    std::pair<int, int> tail = steps < length ? body[length - 1 - steps] : pos;
+    for (int step = 1; step <= steps; ++step) {
+        pos = advance(pos, path[step - 1]);
+        if (step > steps - length) {
+            freeBits.reset(pos.first, pos.second);
+        }
+        if (step == steps - length + 1) {
+            tail = pos;
+        }
+    }
+
+    // 蛇尾所在格子随移动空出，视为可达目标
+    freeBits.set(tail.first, tail.second);
+    regionBits.clear();
+    regionBits.set(pos.first, pos.second);
+    return regionBits.fillUntil(freeBits, tail.first, tail.second);
+}
+
+int Game::regionAfterMove(std::pair<int, int> pos, bool& reachesTail) {
+    auto tail = snake.getBody().back();
+    freeBits.assignFree(obstacleBits, bodyBits);
+    if (snake.occupancyAt(tail.first, tail.second) == 1) {
+        freeBits.set(tail.first, tail.second);
+    }
+    regionBits.clear();
+    regionBits.set(pos.first, pos.second);
+    int region = regionBits.fill(freeBits);
+    reachesTail = regionBits.test(tail.first, tail.second);
+    return region;
 } 
\ No newline at end of file
@@ -1,12 +1,26 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "Board.h"
+#include "BitBoard.h"
 #include "Snake.h"
 #include "Food.h"
-#include <chrono>
+#include "FreeCellIndex.h"
+#include "HamiltonCycle.h"
+#include "AsyncPlanner.h"
+#include "GameState.h"
+#include "LatencyHistogram.h"
+#include "PathFinder.h"
+#include "Random.h"
+#include "Replay.h"
+#include "RewindBuffer.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
-#include <list>
+
+struct GameConfig;
 
 class Game {
 public:
@@ -16,13 +30,47 @@ public:
         HARD
     };
 
+    // 对局结果
+    enum class Outcome {
+        PLAYING,        // 进行中
+        WON,            // 棋盘已填满，胜利
+        HIT_WALL,       // 撞墙
+        HIT_SELF,       // 撞到自己
+        HIT_OBSTACLE    // 撞到障碍物
+    };
+
+    // 自动寻路策略
+    enum class AutoPathStrategy : std::uint8_t {
+        GREEDY,    // 每次朝食物做时间感知 BFS，找不到路径时按方向贪心
+        HAMILTON   // 沿哈密顿回路前进，安全时抄近路；回路覆盖全部空闲格子时可以填满棋盘，
+                   // 否则回路外的食物经回路旁的单个格子绕行吃到，或交给寻路吃到后再回到回路上
+    };
+
     static const int AUTO_PATH_DURATION = 60;  // 自动寻路持续时间（秒）
+    static const int TICK_INTERVAL_MS = 200;   // 每个逻辑帧对应的时长（毫秒）
+    static const int AUTO_PATH_TICKS = AUTO_PATH_DURATION * 1000 / TICK_INTERVAL_MS;  // 自动寻路持续的逻辑帧数
+    static constexpr int MAX_QUEUED_INPUTS = 3;  // 输入队列容量，每个逻辑帧消费一个
+    static const int MAX_SAVES = 5;              // 自动存档轮换使用的槽位数
+    static const int AUTOSAVE_INTERVAL_TICKS = 50;  // 自动存档间隔（逻辑帧，10 秒）
+    // 自动寻路算法的修订号，改变自动寻路走法的修改都要递增，旧录像按原修订号回放：
+    //   0 初版；1 洪水填充存活检查；2 下一步被挡住时局部绕行修复路径；
+    //   3 HAMILTON 回路并入障碍物旁的空闲格子，回路外的食物绕行吃到，不再改用贪心寻路；
+    //   4 HAMILTON 回路上够不到的食物交给带存活检查的寻路，吃到后回到回路上，蛇身顺序按实际位置判断
+    static constexpr int AUTOPILOT_REVISION = 4;
 
     Game();
+    explicit Game(const GameConfig& config);
     ~Game();
 
-    void update();
+    void update();                  // 推进一个逻辑帧
+    int step(int ticks);            // 连续推进若干逻辑帧，返回实际执行的帧数（对局结束或暂停时提前结束）
+    std::uint64_t getTickCount() const { return tickCount; }
+    int getWidth() const { return board.width; }
+    int getHeight() const { return board.height; }
+    const BoardSize& getBoardSize() const { return board; }
     void togglePause();
+    Outcome getOutcome() const { return outcome; }
+    bool isGameOver() const { return outcome != Outcome::PLAYING; }
     bool isPaused() const { return paused; }
     int getScore() const { return score; }
     int getHighScore() const { return highScore; }
@@ -31,21 +79,49 @@ public:
     const Food& getFood() const { return food; }
     Food& getFood() { return food; }
     const std::vector<std::pair<int, int>>& getObstacles() const { return obstacles; }
-    void setDifficulty(Difficulty d) { 
-        difficulty = d; 
-        generateObstacles();
-    }
+    bool isObstacle(int x, int y) const;           // 指定格子是否为障碍物（O(1)）
+    bool submitDirection(Direction newDirection, std::uint64_t arrivalNs = 0);  // 玩家输入方向，排队到之后的逻辑帧应用（会记入录像），队列满或与上一个输入同向、反向时丢弃；arrivalNs 为按键时刻（steadyClockNs），0 表示当前
+    void changeDirection(Direction newDirection);  // 立即改变方向（会记入录像），回放使用
+    void setDifficulty(Difficulty d);              // 切换难度并重新生成障碍物（会记入录像）
     Difficulty getDifficulty() const { return difficulty; }
+    Difficulty getInitialDifficulty() const { return initialDifficulty; }
+    AutoPathStrategy getAutoPathStrategy() const { return autoPathStrategy; }
+    std::uint64_t getSeed() const { return seed; }
+    bool getReplay(Replay& replay) const;           // 导出从开局到当前帧的录像，读档后的对局无法导出
+    void applyReplayEvent(const ReplayEvent& event);
+    void captureState(GameState& state) const;     // 导出完整对局状态
+    bool restoreState(const GameState& state);     // 恢复完整对局状态，棋盘尺寸不符或数据无效时返回 false 且不修改对局
+    bool rewind(std::uint64_t ticks);              // 回退若干逻辑帧（超出回退缓冲区时退到最早的一帧），回退后的对局无法导出录像
+    std::uint64_t getRewindableTicks() const;     // 当前最多能回退的帧数
+    bool isRankable() const { return rankable; }   // 成绩能否计入排行榜，回退后为 false
+    const RewindBuffer& getRewindBuffer() const { return rewindBuffer; }
     bool saveGame(const std::string& filename) const;
     bool loadGame(const std::string& filename);
-    const std::chrono::steady_clock::time_point& getAutoPathStartTime() const { return autoPathStartTime; }
     bool isAutoPathActive() const;
+    std::uint64_t getStateHash() const;       // 完整局面（蛇、食物、障碍物）的 Zobrist 哈希，O(1)
+    std::uint64_t getObstacleHash() const { return obstacleHash; }  // 障碍物集合的哈希，障碍物变化时改变
+    TranspositionTable& getTranspositionTable() { return transpositionTable; }
+    int getAutoPathRemainingTicks() const;    // 自动寻路剩余帧数
+    int getAutoPathRemainingSeconds() const;  // 自动寻路剩余时间（秒，按逻辑帧折算）
+    const LatencyHistogram& getInputLatency() const { return inputLatency; }  // 输入从到达到被逻辑帧应用的延迟
+    const LatencyHistogram& getPlanLatency() const { return planLatency; }    // 自动寻路每次搜索的耗时
+    std::uint64_t getLatePlans() const { return latePlans; }  // 后台规划未及时完成、改用备选方向的次数
+    int getUncoveredCycleCells();             // HAMILTON 回路没有覆盖的空闲格子数，为 0 时回路策略可以填满棋盘
 
 private:
-    static const int WIDTH = 20;
-    static const int HEIGHT = 20;
-    static const int MAX_SAVES = 5;
+    friend class GameBenchmark;  // 基准测试直接测量私有的热点函数
+
+    static const std::size_t TRANSPOSITION_TABLE_BYTES = 64 * 1024;  // 置换表大小
+    static constexpr std::size_t MAX_REPAIR_NODES = 256;  // 路径局部修复最多扩展的节点数
+    static constexpr int SHORTCUT_MARGIN = 2;  // 抄近路后蛇头与蛇尾沿回路至少相隔的格数（吃到食物时蛇尾停一帧）
 
+    BoardSize board;
+    std::uint64_t seed;               // 本局随机数种子
+    Random rng;                       // 本局独立的随机数生成器
+    Difficulty initialDifficulty;     // 开局难度，录像从这里开始重放
+    bool alwaysAutoPath;              // 自动寻路是否常开
+    AutoPathStrategy autoPathStrategy;
+    int autopilotRevision;            // 自动寻路算法的修订号，见 AUTOPILOT_REVISION
     Snake snake;
     Food food;
     int score;
@@ -53,20 +129,98 @@ private:
     bool paused;
     Difficulty difficulty;
     std::vector<std::pair<int, int>> obstacles;
+    std::uint64_t obstacleHash;       // 障碍物集合的 Zobrist 哈希
+    std::vector<std::uint8_t> obstacleGrid;  // 每个格子是否为障碍物
+    BitBoard obstacleBits;            // 障碍物的位棋盘，障碍物变化时重建
+    BitBoard bodyBits;                // 蛇身占据格子的位棋盘，随移动增量维护
+    BitBoard freeBits;                // 安全检查用的临时集合
+    BitBoard regionBits;
+    FreeCellIndex foodCells;          // 可以生成食物的空闲格子，随蛇移动和障碍物变化增量维护
+    Outcome outcome;
     bool autoPathEnabled;
-    std::chrono::steady_clock::time_point autoPathStartTime;
-    std::vector<Direction> currentPath;
+    std::uint64_t tickCount;          // 已执行的逻辑帧数
+    std::uint64_t autoPathStartTick;  // 自动寻路开始时的逻辑帧
+    // 正在跟随的路径按倒序存放：末尾是下一步，走一步只需弹出末尾。
+    // pathCells 是每一步进入的格子，pathSlot 按格子记录它在路径中的位置（需与 pathCells 核对，过期的值不清理）
+    std::vector<Direction> pathSteps;
+    std::vector<std::pair<int, int>> pathCells;
+    std::vector<int> pathSlot;
+    std::vector<Direction> plannedPath;  // 寻路结果缓冲（正序，含第一步）
     bool isFollowingPath;
+    PathFinder pathFinder;
+    std::vector<int> releaseTicks;  // 寻路用：蛇身格子在第几步之后空出，空格子为 0
+    TranspositionTable transpositionTable;  // 以局面哈希缓存规划结果，供各规划器共用
+    HamiltonCycle cycle;                    // HAMILTON 策略的回路，障碍物变化后按需重建
+    bool cycleValid;
+    int cycleRun;                           // 连续沿回路前进的帧数，不小于蛇长时蛇身按回路顺序排列，可以抄近路；
+                                            // 修订 4 起不为 0 表示上一帧已逐节确认过顺序
+    std::vector<ReplayEvent> inputLog;      // 开局以来的外部输入
+    bool replayable;                        // 对局能否从种子和输入完整重放（读档后为 false）
+    bool rankable;                          // 成绩能否计入排行榜（回退过的对局为 false，同一局不会重复提交不同的结局）
+
+    // 排队的玩家输入：带到达时间，每个逻辑帧开始时应用一个
+    struct QueuedInput {
+        Direction direction;
+        std::uint64_t arrivalNs;
+    };
+    QueuedInput inputQueue[MAX_QUEUED_INPUTS];
+    int queuedInputs;
+    LatencyHistogram inputLatency;
+
+    std::unique_ptr<AsyncPlanner> planner;  // 后台规划器，同步模式下为空
+    PlanRequest planRequest;                // 复用的请求缓冲
+    PlanResult planResult;                  // 复用的结果缓冲
+    LatencyHistogram planLatency;
+    std::uint64_t latePlans;
+
+    RewindBuffer rewindBuffer;              // 最近若干帧的关键帧和逐帧增量，预算为 0 时不记录
 
     void generateObstacles();
-    bool isObstacle(int x, int y) const;
-    void saveHighScore() const;
-    void loadHighScore();
+    void rebuildCellIndex();
+    void moveSnake();
+    void spawnFood();
+    void rehashObstacles();
     void enableAutoPath();
     void disableAutoPath();
-    bool isValidPosition(int x, int y, const std::list<std::pair<int, int>>& currentBody) const;
+    bool isValidPosition(int x, int y) const;  // 下一帧蛇头能否进入该格子（O(1)）
     Direction findPathToFood();
+    void pushPath(const std::vector<Direction>& path, std::size_t first);  // 把从蛇头出发的 path[first..] 接在剩余路径之前
+    void clearPath();
+    int pathSlotAt(int x, int y) const;  // 格子在剩余路径中的位置，不在路径上为 -1
+    bool repairPath();                   // 下一步被挡住时绕行接回剩余路径，失败时返回 false
+    void requestPlan();  // 为下一帧的局面提前提交后台规划
+    bool findCycleDirection(Direction& dir);  // HAMILTON 策略的下一步，修订 4 之前蛇头或食物不在回路上、或下一步不安全时返回 false
+    bool findDetour(std::pair<int, int> cell, std::pair<int, int>& entry, std::pair<int, int>& exit);  // 回路外的格子能否绕行经过
+    bool findDetourExit(Direction& dir);      // 蛇头在绕行的格子上时回到回路的一步
+    bool isCycleOrdered();                    // 蛇身是否按回路顺序排列，修订 4 起代替按 cycleRun 估计
+    bool isCycleWalkSafe(std::pair<int, int> start, int step, int length);  // 从 start 沿回路走完一整条蛇长是否安全
+    bool findCycleRejoin(Direction& dir);     // 蛇身打乱后回到回路的一步
+    bool planCycleHandover();                 // 回路上够不到的食物：找一条吃到后还能回到回路的路径
+    bool followCyclePath(Direction& dir);     // 沿交接路径走一步，路径走完或被挡住时返回 false
+    bool isOnCycle(std::pair<int, int> pos);
+    void labelReleaseTicks();
+    void clearReleaseTicks();
     Direction findFallbackDirection();
+    bool isPathSurvivable(const std::vector<Direction>& path);           // 沿路径吃到食物后蛇头能否到达蛇尾
+    int regionAfterMove(std::pair<int, int> pos, bool& reachesTail);   // 蛇头进入 pos 后所在区域的格子数
+    bool isCachedMoveSafe(Direction move);        // 置换表命中的方向在当前局面下是否仍然可走
+    void applyQueuedInput();
+    bool applyState(const GameState& state);  // restoreState 的主体，不改动回退缓冲区
+    void recordRewind(bool grew);             // 把刚结束的一帧记入回退缓冲区
+    static std::pair<int, int> advance(std::pair<int, int> pos, Direction dir);
+};
+
+// 新对局的配置
+struct GameConfig {
+    BoardSize board;                                       // 棋盘尺寸
+    Game::Difficulty difficulty = Game::Difficulty::NORMAL;  // 初始难度
+    std::uint64_t seed = 0;                                // 随机数种子，0 表示使用随机设备
+    int highScore = 0;                                     // 历史最高分（界面从排行榜读取），对局本身不读写文件
+    bool alwaysAutoPath = false;                           // 自动寻路常开（机器人对局）
+    Game::AutoPathStrategy autoPathStrategy = Game::AutoPathStrategy::GREEDY;  // 自动寻路策略
+    int autopilotRevision = Game::AUTOPILOT_REVISION;     // 自动寻路算法的修订号，回放旧录像时按录制时的修订号运行
+    bool asyncPlanner = false;                             // 在后台线程提前规划自动寻路（结果未及时完成时对局不可重放）
+    std::size_t rewindBudgetBytes = 0;                     // 回退缓冲区的内存上限（字节），0 表示不记录
 };
 
 #endif // GAME_H 
\ No newline at end of file
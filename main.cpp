@@ -1,10 +1,56 @@
 #include "mainwindow.h"
+#include "ArenaWindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <algorithm>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
+
+    // 命令行参数：--width / --height 指定棋盘尺寸，--strategy 指定自动寻路策略，
+    // --arena 改为打开竞技场模式（--players 指定其中由键盘控制的蛇数）
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption widthOption("width", "Board width in cells.", "cells",
+                                   QString::number(BoardSize::DEFAULT_SIZE));
+    QCommandLineOption heightOption("height", "Board height in cells.", "cells",
+                                    QString::number(BoardSize::DEFAULT_SIZE));
+    QCommandLineOption strategyOption("strategy", "Autopilot strategy: greedy or hamilton.", "name", "greedy");
+    QCommandLineOption arenaOption("arena", "Play the multi-snake arena with this many snakes.", "snakes");
+    QCommandLineOption playersOption("players", "Arena snakes controlled by the keyboard (0 to 2).", "count", "1");
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.addOption(strategyOption);
+    parser.addOption(arenaOption);
+    parser.addOption(playersOption);
+    parser.process(a);
+
+    if (parser.isSet(arenaOption)) {
+        // 竞技场默认使用 ArenaConfig 的大棋盘，指定了尺寸时才覆盖
+        ArenaConfig arenaConfig;
+        if (parser.isSet(widthOption) || parser.isSet(heightOption)) {
+            arenaConfig.board = BoardSize(parser.value(widthOption).toInt(), parser.value(heightOption).toInt());
+        }
+        arenaConfig.snakeCount = parser.value(arenaOption).toInt();  // 超出棋盘容量时由 Arena 收紧
+        arenaConfig.humanCount = std::min(2, parser.value(playersOption).toInt());  // 只有两套按键
+        arenaConfig.seed = static_cast<std::uint64_t>(QDateTime::currentMSecsSinceEpoch());
+
+        ArenaWindow w(arenaConfig);
+        w.show();
+        return a.exec();
+    }
+
+    GameConfig config;
+    config.board = BoardSize(parser.value(widthOption).toInt(), parser.value(heightOption).toInt());
+    if (parser.value(strategyOption) == "hamilton") {
+        config.autoPathStrategy = Game::AutoPathStrategy::HAMILTON;
+    }
+    config.asyncPlanner = true;  // 界面对局在后台提前规划自动寻路，逻辑帧不等待搜索
+    config.rewindBudgetBytes = 1 << 20;  // 退格键回退最近的对局，历史最多占 1 MB
+
+    MainWindow w(config);
     w.show();
     return a.exec();
-} 
\ No newline at end of file
+}
\ No newline at end of file
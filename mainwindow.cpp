@@ -2,137 +2,238 @@
 #include "./ui_mainwindow.h"
 #include <QPainter>
 #include <QKeyEvent>
+#include <QPaintEvent>
 #include <QMessageBox>
 #include <QFileDialog>
-#include <chrono>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QDir>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 
-MainWindow::MainWindow(QWidget *parent)
+// 排行榜和自动存档放在用户数据目录（不随工作目录变化），目录不存在时创建
+static QString userDataPath(const QString &name)
+{
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(name);
+}
+
+static std::string autosaveDirectory()
+{
+    QString directory = userDataPath("autosave");
+    QDir().mkpath(directory);
+    return directory.toStdString();
+}
+
+static Leaderboard *openLeaderboard()
+{
+    Leaderboard *leaderboard = new Leaderboard(userDataPath("leaderboard.txt").toStdString());
+    // 旧版本把最高分写在工作目录的 highscore.txt 中，首次运行时导入排行榜
+    leaderboard->importHighScore("highscore.txt");
+    return leaderboard;
+}
+
+MainWindow::MainWindow(const GameConfig& config, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , game(new Game())
+    , config(config)
+    , leaderboard(openLeaderboard())
+    , autosave(new AutosaveManager(autosaveDirectory(), Game::MAX_SAVES))
+    , simulation(new SimulationThread(config, leaderboard.get(), autosave.get()))
     , gameTimer(new QTimer(this))
+    , interpolation(1)
+    , boardImageKey(0)
+    , boardImageValid(false)
+    , lastGeneration(0)
+    , lastTick(0)
+    , lastSpecialFood(false)
+    , gameOverShown(false)
 {
     ui->setupUi(this);
-    setFixedSize(GRID_WIDTH * CELL_SIZE + 200, GRID_HEIGHT * CELL_SIZE + 80);  // 进一步增加顶部空间
+    simulation->acquireSnapshot();
 
-    // 连接定时器信号
+    // 大棋盘缩小格子，使游戏区域不超过 MAX_BOARD_PIXELS
+    int longestSide = std::max(snapshot().width, snapshot().height);
+    cellSize = std::max(1, std::min(MAX_CELL_SIZE, MAX_BOARD_PIXELS / longestSide));
+    int boardHeight = std::max(snapshot().height * cellSize, PANEL_HEIGHT);
+    setFixedSize(snapshot().width * cellSize + PANEL_WIDTH, boardHeight + 2 * BOARD_TOP);  // 进一步增加顶部空间
+    prevHead = lastHead = snapshot().body.front();
+    prevTail = lastTail = snapshot().body.back();
+    syncView();
+
+    // 渲染帧跟随屏幕刷新率，与逻辑帧间隔无关
+    qreal refreshRate = 60;
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        refreshRate = std::max<qreal>(1, screen->refreshRate());
+    }
     connect(gameTimer, &QTimer::timeout, this, &MainWindow::updateGame);
-    gameTimer->start(200);  // 200ms 更新一次
+    gameTimer->setTimerType(Qt::PreciseTimer);
+    gameTimer->start(std::max(1, qRound(1000 / refreshRate)));
+
+    // 上次运行留下了未结束的对局（例如异常退出）时，窗口显示后询问是否恢复。
+    // 局面在这里先读出来，新对局的存档随后轮换覆盖槽位也不受影响
+    GameState recovered;
+    if (autosave->loadLatest(recovered) && recovered.outcome == static_cast<std::uint8_t>(Game::Outcome::PLAYING)) {
+        QTimer::singleShot(0, this, [this, recovered]() {
+            if (QMessageBox::question(this, "Autosave", "Resume the unfinished game from the last autosave?") ==
+                QMessageBox::Yes) {
+                restoreAutosave(recovered);
+            }
+        });
+    }
 }
 
 MainWindow::~MainWindow()
 {
     delete ui;
-    delete game;
+}
+
+void MainWindow::postDirection(Direction direction)
+{
+    simulation->post({SimulationCommand::Kind::DIRECTION, static_cast<std::uint8_t>(direction), steadyClockNs()});
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
-    if (!game->isPaused()) {
+    if (!snapshot().paused) {
         switch (event->key()) {
             case Qt::Key_Up:
-                game->getSnake().changeDirection(Direction::UP);
+                postDirection(Direction::UP);
                 break;
             case Qt::Key_Down:
-                game->getSnake().changeDirection(Direction::DOWN);
+                postDirection(Direction::DOWN);
                 break;
             case Qt::Key_Left:
-                game->getSnake().changeDirection(Direction::LEFT);
+                postDirection(Direction::LEFT);
                 break;
             case Qt::Key_Right:
-                game->getSnake().changeDirection(Direction::RIGHT);
+                postDirection(Direction::RIGHT);
                 break;
             case Qt::Key_P:
-                game->togglePause();
+                simulation->post({SimulationCommand::Kind::TOGGLE_PAUSE, 0, steadyClockNs()});
                 break;
         }
     }
+    // 回退在暂停和对局结束后也可用
+    if (event->key() == Qt::Key_Backspace) {
+        simulation->post({SimulationCommand::Kind::REWIND, REWIND_SECONDS, steadyClockNs()});
+    }
     QMainWindow::keyPressEvent(event);
 }
 
 void MainWindow::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
     QPainter painter(this);
-    drawGame(painter);
+    drawGame(painter, event->rect());
 }
 
-void MainWindow::drawGame(QPainter &painter)
+void MainWindow::drawGame(QPainter &painter, const QRect &dirty)
 {
+    const GameSnapshot &view = snapshot();
+
+    // 障碍物或屏幕缩放变化后重新拼帧缓冲
+    int cellPixels = std::max(1, qRound(cellSize * devicePixelRatioF()));
+    if (!boardImageValid || boardImageKey != view.obstacleHash || atlas.getCellPixels() != cellPixels) {
+        rebuildBoardImage();
+    }
+
+    // 绘制背景
+    painter.fillRect(dirty, Qt::black);
+
+    // 棋盘区域直接从帧缓冲拷贝脏区域
+    QRect boardRect(0, BOARD_TOP, view.width * cellSize, view.height * cellSize);
+    QRect target = dirty & boardRect;
+    if (!target.isEmpty()) {
+        qreal scale = static_cast<qreal>(atlas.getCellPixels()) / cellSize;
+        QRectF source(target.x() * scale, (target.y() - BOARD_TOP) * scale,
+                      target.width() * scale, target.height() * scale);
+        painter.drawImage(QRectF(target), boardImage, source);
+    }
+
     // 设置抗锯齿
     painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 绘制背景
-    painter.fillRect(rect(), Qt::black);
-    
+    painter.setClipRect(dirty);
+
+    if (interpolation < 1.0 && prevHead != lastHead) {
+        drawMotion(painter);
+    }
+
     // 将游戏区域向下移动
-    painter.translate(0, 40);  // 向下移动40像素，确保在菜单栏下方
-    
-    // 绘制游戏元素
+    painter.translate(0, BOARD_TOP);  // 向下移动，确保在菜单栏下方
+
     drawBorder(painter);
-    drawSnake(painter);
-    drawFood(painter);
-    drawObstacles(painter);
-    drawScore(painter);
+    if (dirty.intersects(panelRect())) {
+        drawScore(painter);
+    }
 }
 
-void MainWindow::drawSnake(QPainter &painter)
+void MainWindow::drawMotion(QPainter &painter)
 {
-    painter.setBrush(Qt::green);
-    painter.setPen(Qt::NoPen);
-    
-    for (const auto& segment : game->getSnake().getBody()) {
-        QRectF rect(segment.first * CELL_SIZE + 1, 
-                   segment.second * CELL_SIZE + 1,
-                   CELL_SIZE - 2, 
-                   CELL_SIZE - 2);
-        painter.drawRoundedRect(rect, 5, 5);
+    // 帧缓冲是当前逻辑帧的画面，这里把蛇头和蛇尾画回上一帧与当前帧之间的插值位置
+    auto lerpRect = [&](const std::pair<int, int> &from, const std::pair<int, int> &to) {
+        QRectF a = cellRect(from);
+        QRectF b = cellRect(to);
+        return QRectF(a.x() + (b.x() - a.x()) * interpolation, a.y() + (b.y() - a.y()) * interpolation,
+                      cellSize, cellSize);
+    };
+    const QImage &sprites = atlas.getImage();
+
+    // 新蛇头格子先清空，蛇头从上一格滑入
+    painter.fillRect(cellRect(lastHead), Qt::black);
+    if (prevTail != lastTail) {
+        painter.drawImage(lerpRect(prevTail, lastTail), sprites, atlas.spriteRect(SpriteAtlas::Sprite::BODY));
     }
+    painter.drawImage(lerpRect(prevHead, lastHead), sprites, atlas.spriteRect(SpriteAtlas::Sprite::HEAD));
 }
 
-void MainWindow::drawFood(QPainter &painter)
+void MainWindow::rebuildBoardImage()
 {
-    auto foodPos = game->getFood().getPosition();
-    if (game->getFood().isSpecial()) {
-        painter.setBrush(Qt::yellow);
-    } else {
-        painter.setBrush(Qt::red);
+    const GameSnapshot &view = snapshot();
+    int cellPixels = std::max(1, qRound(cellSize * devicePixelRatioF()));
+    if (atlas.getCellPixels() != cellPixels) {
+        atlas.rebuild(cellPixels);
     }
-    painter.setPen(Qt::NoPen);
-    
-    QRectF rect(foodPos.first * CELL_SIZE + 1,
-                foodPos.second * CELL_SIZE + 1,
-                CELL_SIZE - 2,
-                CELL_SIZE - 2);
-    painter.drawEllipse(rect);
+    boardImage = QImage(view.width * cellPixels, view.height * cellPixels, atlas.getFormat());
+    boardImage.fill(Qt::black);
+
+    // 与原先的绘制顺序一致：蛇、食物，障碍物在最上层
+    bool isHead = true;
+    view.body.forEach([&](const std::pair<int, int> &cell) {
+        if (!isHead) atlas.blit(boardImage, cell.first, cell.second, SpriteAtlas::Sprite::BODY);
+        isHead = false;
+    });
+    if (!view.body.empty()) {
+        atlas.blit(boardImage, view.body.front().first, view.body.front().second, SpriteAtlas::Sprite::HEAD);
+    }
+    atlas.blit(boardImage, view.food.first, view.food.second,
+               view.specialFood ? SpriteAtlas::Sprite::FOOD_SPECIAL : SpriteAtlas::Sprite::FOOD_NORMAL);
+    for (const auto& obstacle : view.obstacles) {
+        atlas.blit(boardImage, obstacle.first, obstacle.second, SpriteAtlas::Sprite::OBSTACLE);
+    }
+
+    boardImageKey = view.obstacleHash;
+    boardImageValid = true;
 }
 
-void MainWindow::drawObstacles(QPainter &painter)
+void MainWindow::blitCell(const std::pair<int, int> &cell, SpriteAtlas::Sprite sprite)
 {
-    painter.setBrush(Qt::gray);
-    painter.setPen(Qt::NoPen);
-    
-    for (const auto& obstacle : game->getObstacles()) {
-        QRectF rect(obstacle.first * CELL_SIZE + 1,
-                   obstacle.second * CELL_SIZE + 1,
-                   CELL_SIZE - 2,
-                   CELL_SIZE - 2);
-        painter.drawRect(rect);
-    }
+    atlas.blit(boardImage, cell.first, cell.second, sprite);  // 棋盘外的格子不拷贝
+    update(cellRect(cell));
 }
 
-void MainWindow::drawScore(QPainter &painter)
+QStringList MainWindow::infoLines() const
 {
-    painter.setPen(Qt::white);
-    painter.setFont(QFont("Arial", 12));
-    
-    // 将分数显示移到更下方，避免被菜单栏遮挡
-    QString scoreText = QString("Score: %1").arg(game->getScore());
-    QString highScoreText = QString("High Score: %1").arg(game->getHighScore());
-    QString difficultyText = "Difficulty: ";
-    
+    const GameSnapshot &view = snapshot();
+    QStringList lines;
+    lines << QString("Score: %1").arg(view.score);
+    lines << QString("High Score: %1").arg(view.highScore);
+
     // 添加当前难度显示
-    switch (game->getDifficulty()) {
+    QString difficultyText = "Difficulty: ";
+    switch (view.difficulty) {
         case Game::Difficulty::EASY:
             difficultyText += "Easy";
             break;
@@ -143,59 +244,175 @@ void MainWindow::drawScore(QPainter &painter)
             difficultyText += "Hard";
             break;
     }
-    
-    // 调整显示位置，从菜单栏下方开始
-    int startY = 50;  // 调整起始位置
-    painter.drawText(GRID_WIDTH * CELL_SIZE + 10, startY, scoreText);
-    painter.drawText(GRID_WIDTH * CELL_SIZE + 10, startY + 30, highScoreText);
-    painter.drawText(GRID_WIDTH * CELL_SIZE + 10, startY + 60, difficultyText);
-    
+    lines << difficultyText;
+
     // 添加自动控制剩余时间显示
-    if (game->isAutoPathActive()) {
-        auto now = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-            now - game->getAutoPathStartTime());
-        int remainingTime = Game::AUTO_PATH_DURATION - duration.count();
-        QString autoText = QString("Auto Control: %1s").arg(remainingTime);
-        painter.drawText(GRID_WIDTH * CELL_SIZE + 10, startY + 90, autoText);
+    if (view.autoPathActive) {
+        lines << QString("Auto Control: %1s").arg(view.autoPathRemainingSeconds);
+    } else {
+        lines << QString();
     }
+
+    lines << (view.paused ? QString("PAUSED") : QString());
+    // 括号内为落后时补跑的帧数
+    lines << QString("Tick Jitter: %1 ms (%2)").arg(view.tickJitterMs, 0, 'f', 1).arg(static_cast<qulonglong>(view.catchUpTicks));
+
+    // 输入延迟：按键到达到被逻辑帧应用的时间
+    if (view.inputCount > 0) {
+        lines << QString("Input p50/p99: %1/%2 ms")
+                     .arg(view.inputP50Ns / 1e6, 0, 'f', 0)
+                     .arg(view.inputP99Ns / 1e6, 0, 'f', 0);
+    }
+
+    // 自动寻路单次搜索耗时，括号内为后台规划来不及、改用备选方向的次数
+    if (view.planCount > 0 || view.latePlans > 0) {
+        lines << QString("Plan p50/p99: %1/%2 us (%3)")
+                     .arg(view.planP50Ns / 1e3, 0, 'f', 0)
+                     .arg(view.planP99Ns / 1e3, 0, 'f', 0)
+                     .arg(view.latePlans);
+    }
+    return lines;
+}
+
+void MainWindow::drawScore(QPainter &painter)
+{
+    painter.setPen(Qt::white);
+    painter.setFont(QFont("Arial", 12));
     
-    if (game->isPaused()) {
-        painter.drawText(GRID_WIDTH * CELL_SIZE + 10, startY + 120, "PAUSED");
+    // 调整显示位置，从菜单栏下方开始
+    int startY = 50;  // 调整起始位置
+    const QStringList lines = infoLines();
+    for (int i = 0; i < lines.size(); ++i) {
+        if (!lines[i].isEmpty()) {
+            painter.drawText(snapshot().width * cellSize + 10, startY + 30 * i, lines[i]);
+        }
     }
 }
 
 void MainWindow::drawBorder(QPainter &painter)
 {
     painter.setPen(QPen(Qt::white, 2));
-    painter.drawRect(0, 0, GRID_WIDTH * CELL_SIZE, GRID_HEIGHT * CELL_SIZE);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(0, 0, snapshot().width * cellSize, snapshot().height * cellSize);
+}
+
+QRect MainWindow::cellRect(const std::pair<int, int> &cell) const
+{
+    return QRect(cell.first * cellSize, cell.second * cellSize + BOARD_TOP, cellSize, cellSize);
+}
+
+QRect MainWindow::panelRect() const
+{
+    // 边框画笔宽 2 像素，信息栏从边框外侧开始
+    int left = snapshot().width * cellSize + 2;
+    return QRect(left, 0, width() - left, height());
+}
+
+void MainWindow::syncView()
+{
+    const GameSnapshot &view = snapshot();
+    std::pair<int, int> head = view.body.front();
+    std::pair<int, int> tail = view.body.back();
+    QStringList info = infoLines();
+    bool gameOver = view.outcome != Game::Outcome::PLAYING;
+    bool oneTick = view.generation == lastGeneration && view.tick == lastTick + 1;
+    if (view.generation != lastGeneration) {
+        gameOverShown = false;  // 新对局或读档后重新允许弹出结束提示
+    }
+
+    if (!boardImageValid || boardImageKey != view.obstacleHash || gameOver ||
+        (view.tick != lastTick && !oneTick) || view.generation != lastGeneration) {
+        // 对局被替换、障碍物变化、对局结束或跨越多帧时整体重绘，帧缓冲在绘制时重新拼
+        boardImageValid = false;
+        update();
+    } else {
+        // 一帧内只有旧蛇尾、新旧蛇头和新旧食物所在的格子可能变化，按从下到上的层次依次拷贝
+        bool foodChanged = view.food != lastFood || view.specialFood != lastSpecialFood;
+        if (tail != lastTail) blitCell(lastTail, SpriteAtlas::Sprite::EMPTY);
+        if (foodChanged) blitCell(lastFood, SpriteAtlas::Sprite::EMPTY);
+        if (head != lastHead && view.body.size() > 1 && view.body.at(1) == lastHead) {
+            blitCell(lastHead, SpriteAtlas::Sprite::BODY);
+        }
+        if (foodChanged) {
+            blitCell(view.food, view.specialFood ? SpriteAtlas::Sprite::FOOD_SPECIAL : SpriteAtlas::Sprite::FOOD_NORMAL);
+        }
+        if (head != lastHead) blitCell(head, SpriteAtlas::Sprite::HEAD);
+        if (info != lastInfo) update(panelRect());
+    }
+
+    // 只前进一帧时记录上一帧的蛇头蛇尾用于插值，否则直接显示当前帧
+    if (oneTick && !gameOver) {
+        prevHead = lastHead;
+        prevTail = lastTail;
+    } else if (view.tick != lastTick || view.generation != lastGeneration || gameOver) {
+        prevHead = head;
+        prevTail = tail;
+    }
+
+    lastGeneration = view.generation;
+    lastTick = view.tick;
+    lastHead = head;
+    lastTail = tail;
+    lastFood = view.food;
+    lastSpecialFood = view.specialFood;
+    lastInfo = info;
+}
+
+void MainWindow::setInterpolation(double alpha)
+{
+    if (prevHead == lastHead && prevTail == lastTail) {
+        interpolation = 1;
+        return;
+    }
+    if (alpha == interpolation) return;
+    interpolation = alpha;
+    // 只有上一帧与当前帧的蛇头、蛇尾格子需要重绘
+    update(cellRect(prevHead) | cellRect(lastHead));
+    update(cellRect(prevTail) | cellRect(lastTail));
 }
 
 void MainWindow::updateGame()
 {
-    if (!game->isPaused()) {
-        game->update();
-        if (!game->getSnake().getIsAlive()) {
-            gameTimer->stop();
-            QMessageBox::information(this, "Game Over", 
-                QString("Game Over!\nScore: %1").arg(game->getScore()));
+    // 取模拟线程最新发布的画面（无锁），没有新画面时只推进插值
+    if (simulation->acquireSnapshot()) {
+        syncView();
+    }
+    const GameSnapshot &view = snapshot();
+
+    if (view.outcome != Game::Outcome::PLAYING) {
+        setInterpolation(1);
+        if (!gameOverShown) {
+            gameOverShown = true;
+            if (view.outcome == Game::Outcome::WON) {
+                QMessageBox::information(this, "You Win",
+                    QString("Board cleared!\nScore: %1").arg(view.score));
+            } else {
+                QMessageBox::information(this, "Game Over",
+                    QString("Game Over!\nScore: %1").arg(view.score));
+            }
         }
-        update();  // 触发重绘
+        return;
     }
+
+    // 按距离该帧的时间插值，下一帧迟到时停在当前帧
+    double alpha = 1;
+    if (!view.paused) {
+        std::uint64_t now = steadyClockNs();
+        std::uint64_t sinceTick = now > view.tickTimeNs ? now - view.tickTimeNs : 0;
+        alpha = std::min(1.0, static_cast<double>(sinceTick) / SimulationThread::TICK_INTERVAL_NS);
+    }
+    setInterpolation(alpha);
 }
 
 void MainWindow::on_actionNew_Game_triggered()
 {
-    Game::Difficulty currentDifficulty = game->getDifficulty();
-    delete game;
-    game = new Game();
-    game->setDifficulty(currentDifficulty);  // 保持当前难度
-    gameTimer->start(200);
+    config.difficulty = snapshot().difficulty;  // 保持当前难度
+    simulation->reset(config);
 }
 
 void MainWindow::on_actionPause_triggered()
 {
-    game->togglePause();
+    simulation->post({SimulationCommand::Kind::TOGGLE_PAUSE, 0, steadyClockNs()});
 }
 
 void MainWindow::on_actionSave_triggered()
@@ -203,7 +420,8 @@ void MainWindow::on_actionSave_triggered()
     QString fileName = QFileDialog::getSaveFileName(this,
         "Save Game", "", "Snake Game Files (*.snake)");
     if (!fileName.isEmpty()) {
-        if (game->saveGame(fileName.toStdString())) {
+        std::string path = fileName.toStdString();
+        if (simulation->withGame([&](Game &game) { return game.saveGame(path); })) {
             QMessageBox::information(this, "Success", "Game saved successfully!");
         } else {
             QMessageBox::warning(this, "Error", "Failed to save game!");
@@ -216,7 +434,8 @@ void MainWindow::on_actionLoad_triggered()
     QString fileName = QFileDialog::getOpenFileName(this,
         "Load Game", "", "Snake Game Files (*.snake)");
     if (!fileName.isEmpty()) {
-        if (game->loadGame(fileName.toStdString())) {
+        std::string path = fileName.toStdString();
+        if (simulation->withGame([&](Game &game) { return game.loadGame(path); })) {
             QMessageBox::information(this, "Success", "Game loaded successfully!");
         } else {
             QMessageBox::warning(this, "Error", "Failed to load game!");
@@ -224,31 +443,113 @@ void MainWindow::on_actionLoad_triggered()
     }
 }
 
+void MainWindow::on_actionSave_Replay_triggered()
+{
+    Replay replay;
+    if (!simulation->withGame([&](Game &game) { return game.getReplay(replay); })) {
+        QMessageBox::warning(this, "Error", "A loaded game cannot be saved as a replay!");
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this,
+        "Save Replay", "", "Snake Replay Files (*.snakereplay)");
+    if (!fileName.isEmpty()) {
+        if (replay.save(fileName.toStdString())) {
+            QMessageBox::information(this, "Success", "Replay saved successfully!");
+        } else {
+            QMessageBox::warning(this, "Error", "Failed to save replay!");
+        }
+    }
+}
+
+void MainWindow::on_actionExport_Input_Latency_triggered()
+{
+    LatencyHistogram latency = simulation->withGame([](Game &game) { return game.getInputLatency(); });
+    QString fileName = QFileDialog::getSaveFileName(this,
+        "Export Input Latency", "", "CSV Files (*.csv)");
+    if (!fileName.isEmpty()) {
+        std::ofstream file(fileName.toStdString());
+        if (file.is_open()) {
+            latency.write(file);
+        }
+        if (file.good()) {
+            QMessageBox::information(this, "Success", "Input latency exported successfully!");
+        } else {
+            QMessageBox::warning(this, "Error", "Failed to export input latency!");
+        }
+    }
+}
+
+void MainWindow::on_actionLeaderboard_triggered()
+{
+    static const char *DIFFICULTY_NAMES[] = {"Easy", "Normal", "Hard"};
+    std::vector<LeaderboardEntry> entries = leaderboard->getEntries();
+    QStringList lines;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const LeaderboardEntry &entry = entries[i];
+        double seconds = static_cast<double>(entry.durationTicks) * Game::TICK_INTERVAL_MS / 1000;
+        lines << QString("%1. %2  length %3  %4  %5s  seed %6")
+                     .arg(i + 1).arg(entry.score).arg(entry.length)
+                     .arg(DIFFICULTY_NAMES[std::min<int>(entry.difficulty, 2)])
+                     .arg(seconds, 0, 'f', 1).arg(entry.seed);
+    }
+    if (lines.isEmpty()) {
+        lines << "No games recorded yet.";
+    }
+    QMessageBox::information(this, "Leaderboard", lines.join("\n"));
+}
+
+void MainWindow::on_actionRestore_Autosave_triggered()
+{
+    GameState state;
+    if (!autosave->loadLatest(state)) {
+        QMessageBox::warning(this, "Error", "No autosave found!");
+        return;
+    }
+    restoreAutosave(state);
+}
+
+void MainWindow::restoreAutosave(const GameState &state)
+{
+    // 尺寸不符单独提示，其余失败（数据无效）按存档损坏处理
+    if (state.width != config.board.width || state.height != config.board.height) {
+        QMessageBox::warning(this, "Error",
+            QString("The autosave was made on a %1x%2 board, but the current board is %3x%4!")
+                .arg(state.width).arg(state.height).arg(config.board.width).arg(config.board.height));
+        return;
+    }
+    if (simulation->withGame([&](Game &game) { return game.restoreState(state); })) {
+        QMessageBox::information(this, "Success", "Autosave restored successfully!");
+    } else {
+        QMessageBox::warning(this, "Error", "The autosave is corrupt and could not be restored!");
+    }
+}
+
 void MainWindow::on_actionExit_triggered()
 {
     close();
 }
 
-void MainWindow::on_actionEasy_triggered()
+void MainWindow::changeDifficulty(Game::Difficulty difficulty)
 {
-    game->setDifficulty(Game::Difficulty::EASY);
-    if (!game->getSnake().getIsAlive()) {
-        on_actionNew_Game_triggered();
+    if (snapshot().outcome != Game::Outcome::PLAYING) {
+        config.difficulty = difficulty;
+        simulation->reset(config);
+    } else {
+        simulation->post({SimulationCommand::Kind::DIFFICULTY, static_cast<std::uint8_t>(difficulty), steadyClockNs()});
     }
 }
 
+void MainWindow::on_actionEasy_triggered()
+{
+    changeDifficulty(Game::Difficulty::EASY);
+}
+
 void MainWindow::on_actionNormal_triggered()
 {
-    game->setDifficulty(Game::Difficulty::NORMAL);
-    if (!game->getSnake().getIsAlive()) {
-        on_actionNew_Game_triggered();
-    }
+    changeDifficulty(Game::Difficulty::NORMAL);
 }
 
 void MainWindow::on_actionHard_triggered()
 {
-    game->setDifficulty(Game::Difficulty::HARD);
-    if (!game->getSnake().getIsAlive()) {
-        on_actionNew_Game_triggered();
-    }
-} 
\ No newline at end of file
+    changeDifficulty(Game::Difficulty::HARD);
+}
\ No newline at end of file
@@ -1,9 +1,16 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QImage>
 #include <QMainWindow>
+#include <QStringList>
 #include <QTimer>
 #include "game.h"
+#include "Leaderboard.h"
+#include "AutosaveManager.h"
+#include "SimulationThread.h"
+#include "SpriteAtlas.h"
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -14,7 +21,7 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(const GameConfig& config = GameConfig(), QWidget *parent = nullptr);
     ~MainWindow();
 
 protected:
@@ -27,6 +34,10 @@ private slots:
     void on_actionPause_triggered();
     void on_actionSave_triggered();
     void on_actionLoad_triggered();
+    void on_actionSave_Replay_triggered();
+    void on_actionExport_Input_Latency_triggered();
+    void on_actionLeaderboard_triggered();
+    void on_actionRestore_Autosave_triggered();
     void on_actionExit_triggered();
     void on_actionEasy_triggered();
     void on_actionNormal_triggered();
@@ -34,17 +45,54 @@ private slots:
 
 private:
     Ui::MainWindow *ui;
-    Game *game;
-    QTimer *gameTimer;
-    static const int CELL_SIZE = 20;  // 每个格子的像素大小
-    static const int GRID_WIDTH = 20;  // 游戏区域宽度（格子数）
-    static const int GRID_HEIGHT = 20; // 游戏区域高度（格子数）
-
-    void drawGame(QPainter &painter);
-    void drawSnake(QPainter &painter);
-    void drawFood(QPainter &painter);
-    void drawObstacles(QPainter &painter);
+    GameConfig config;  // 新对局使用的配置（棋盘尺寸、难度）
+    std::unique_ptr<Leaderboard> leaderboard;      // 排行榜，存放在用户数据目录；须先于模拟线程构造、后于它析构
+    std::unique_ptr<AutosaveManager> autosave;     // 自动存档，同上
+    std::unique_ptr<SimulationThread> simulation;  // 对局在模拟线程上推进，界面只读取它发布的画面
+    QTimer *gameTimer;  // 渲染定时器，按屏幕刷新率触发
+    int cellSize;       // 每个格子的像素大小，随棋盘尺寸缩放
+    static constexpr int MAX_CELL_SIZE = 20;     // 格子的最大像素大小
+    static constexpr int MAX_BOARD_PIXELS = 800; // 游戏区域的最大像素边长
+    static constexpr int BOARD_TOP = 40;         // 游戏区域顶部偏移，留出菜单栏
+    static constexpr int PANEL_WIDTH = 200;      // 右侧信息栏宽度
+    static constexpr int PANEL_HEIGHT = 250;     // 信息栏所需的最小高度
+    static constexpr int REWIND_SECONDS = 5;     // 每按一次退格键回退的时长
+
+    // 渲染插值：蛇头和蛇尾在上一帧与当前帧的格子之间平滑移动
+    double interpolation;          // 当前渲染帧在两个逻辑帧之间的位置 [0, 1]
+    std::pair<int, int> prevHead;  // 上一逻辑帧的蛇头
+    std::pair<int, int> prevTail;  // 上一逻辑帧的蛇尾
+
+    // 棋盘帧缓冲：由贴图集按格子拼成，逻辑帧之间只重新拷贝变化的格子，绘制时拷贝脏区域
+    SpriteAtlas atlas;
+    QImage boardImage;
+    std::uint64_t boardImageKey;   // 生成帧缓冲时的障碍物哈希
+    bool boardImageValid;
+
+    // 上次同步时的画面状态，逻辑帧之间只重绘发生变化的格子
+    std::uint64_t lastGeneration;
+    std::uint64_t lastTick;
+    std::pair<int, int> lastHead;
+    std::pair<int, int> lastTail;
+    std::pair<int, int> lastFood;
+    bool lastSpecialFood;
+    QStringList lastInfo;
+    bool gameOverShown;            // 本局结束提示是否已弹出
+
+    const GameSnapshot &snapshot() const { return simulation->getSnapshot(); }
+    void drawGame(QPainter &painter, const QRect &dirty);
     void drawScore(QPainter &painter);
     void drawBorder(QPainter &painter);
+    void drawMotion(QPainter &painter);
+    void rebuildBoardImage();
+    void blitCell(const std::pair<int, int> &cell, SpriteAtlas::Sprite sprite);  // 拷贝一个格子的贴图并使其失效
+    QStringList infoLines() const;
+    QRect cellRect(const std::pair<int, int> &cell) const;  // 格子在窗口中的矩形
+    QRect panelRect() const;
+    void syncView();        // 取到新画面后对比上次状态，只使变化的区域失效
+    void setInterpolation(double alpha);
+    void changeDifficulty(Game::Difficulty difficulty);
+    void postDirection(Direction direction);
+    void restoreAutosave(const GameState &state);
 };
-#endif // MAINWINDOW_H 
\ No newline at end of file
+#endif // MAINWINDOW_H
\ No newline at end of file
@@ -0,0 +1,15 @@
+# 批量模拟：在所有核心上运行大量自动寻路对局并输出统计
+CONFIG -= qt app_bundle
+CONFIG += console thread
+
+TARGET = snake-batch
+TEMPLATE = app
+
+include(snake-core.pri)
+
+SOURCES += \
+    batch.cpp \
+    BatchRunner.cpp
+
+HEADERS += \
+    BatchRunner.h
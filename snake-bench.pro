@@ -0,0 +1,11 @@
+# 微基准测试：测量引擎热点函数的耗时，可输出 JSON
+CONFIG -= qt app_bundle
+CONFIG += console thread
+
+TARGET = snake-bench
+TEMPLATE = app
+
+include(snake-core.pri)
+
+SOURCES += \
+    benchmark.cpp
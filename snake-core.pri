@@ -0,0 +1,53 @@
+# 游戏核心（Game/Snake/Food），不依赖 Qt，可在无界面环境下按逻辑帧驱动
+CONFIG += c++17 thread
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/game.cpp \
+    $$PWD/Arena.cpp \
+    $$PWD/AtomicFile.cpp \
+    $$PWD/AutosaveManager.cpp \
+    $$PWD/BitBoard.cpp \
+    $$PWD/AsyncPlanner.cpp \
+    $$PWD/Snake.cpp \
+    $$PWD/Food.cpp \
+    $$PWD/FreeCellIndex.cpp \
+    $$PWD/HamiltonCycle.cpp \
+    $$PWD/Leaderboard.cpp \
+    $$PWD/MappedFile.cpp \
+    $$PWD/PackedBody.cpp \
+    $$PWD/PathFinder.cpp \
+    $$PWD/Replay.cpp \
+    $$PWD/RewindBuffer.cpp \
+    $$PWD/SaveFile.cpp \
+    $$PWD/SimulationThread.cpp \
+    $$PWD/TranspositionTable.cpp
+
+HEADERS += \
+    $$PWD/game.h \
+    $$PWD/Arena.h \
+    $$PWD/AsyncPlanner.h \
+    $$PWD/AtomicFile.h \
+    $$PWD/AutosaveManager.h \
+    $$PWD/Board.h \
+    $$PWD/BitBoard.h \
+    $$PWD/Snake.h \
+    $$PWD/Food.h \
+    $$PWD/FreeCellIndex.h \
+    $$PWD/GameState.h \
+    $$PWD/HamiltonCycle.h \
+    $$PWD/Leaderboard.h \
+    $$PWD/LatencyHistogram.h \
+    $$PWD/MappedFile.h \
+    $$PWD/PackedBody.h \
+    $$PWD/PathFinder.h \
+    $$PWD/Random.h \
+    $$PWD/Replay.h \
+    $$PWD/RewindBuffer.h \
+    $$PWD/SaveFile.h \
+    $$PWD/SimulationThread.h \
+    $$PWD/SpscQueue.h \
+    $$PWD/TranspositionTable.h \
+    $$PWD/TripleBuffer.h \
+    $$PWD/Zobrist.h
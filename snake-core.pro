@@ -0,0 +1,8 @@
+# 无界面的游戏核心静态库，供机器人评估、压力测试等工具链接
+CONFIG -= qt
+CONFIG += staticlib
+
+TARGET = snake-core
+TEMPLATE = lib
+
+include(snake-core.pri)
@@ -5,18 +5,18 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = snake-qt
 TEMPLATE = app
 
+include(snake-core.pri)
+
 SOURCES += \
     main.cpp \
+    ArenaWindow.cpp \
     mainwindow.cpp \
-    game.cpp \
-    snake.cpp \
-    food.cpp
+    SpriteAtlas.cpp
 
 HEADERS += \
+    ArenaWindow.h \
     mainwindow.h \
-    game.h \
-    snake.h \
-    food.h
+    SpriteAtlas.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,11 @@
+# 回归检查：竞技场碰撞判定、存档往返等固定局面，失败时返回非 0；make check 时运行
+CONFIG -= qt app_bundle
+CONFIG += console thread testcase
+
+TARGET = snake-tests
+TEMPLATE = app
+
+include(snake-core.pri)
+
+SOURCES += \
+    tests.cpp
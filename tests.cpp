@@ -0,0 +1,268 @@
+#include "Arena.h"
+#include "game.h"
+#include "GameState.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --filter TEXT     run only checks whose name contains TEXT\n",
+                program);
+}
+
+// 竞技场碰撞判定的固定局面：摆好各条蛇和食物，推进若干帧后检查每条蛇的存活情况
+struct ArenaScenario {
+    const char* name;
+    std::vector<std::vector<std::pair<int, int>>> bodies;  // 从头到尾
+    std::vector<Direction> directions;
+    std::vector<std::pair<int, int>> food;
+    int ticks;
+    std::vector<bool> survives;
+};
+
+bool runArenaScenario(const ArenaScenario& scenario) {
+    ArenaConfig config;
+    config.board = BoardSize(16, 16);
+    config.snakeCount = static_cast<int>(scenario.bodies.size());
+    config.humanCount = config.snakeCount;  // 方向全部由局面指定
+    config.foodCount = 0;
+    config.initialLength = 1;
+    config.respawnTicks = 0;
+    Arena arena(config);
+    for (int i = 0; i < config.snakeCount; ++i) {
+        arena.removeSnake(i);
+    }
+    for (int i = 0; i < config.snakeCount; ++i) {
+        if (!arena.placeSnake(i, scenario.bodies[i], scenario.directions[i])) return false;
+    }
+    for (const auto& cell : scenario.food) {
+        if (!arena.placeFood(cell.first, cell.second)) return false;
+    }
+    for (int t = 0; t < scenario.ticks; ++t) {
+        arena.update();
+    }
+    for (int i = 0; i < config.snakeCount; ++i) {
+        if (arena.isAlive(i) != scenario.survives[i]) return false;
+    }
+    return true;
+}
+
+int checkArena(const char* filter) {
+    using D = Direction;
+    const std::vector<ArenaScenario> scenarios = {
+        {"wall", {{{0, 5}}}, {D::LEFT}, {}, 1, {false}},
+        {"head-on into one cell", {{{4, 5}}, {{6, 5}}}, {D::RIGHT, D::LEFT}, {}, 1, {false, false}},
+        {"three heads into one cell", {{{4, 5}}, {{6, 5}}, {{5, 6}}}, {D::RIGHT, D::LEFT, D::UP}, {}, 1,
+         {false, false, false}},
+        {"swap of length-1 snakes", {{{5, 5}}, {{6, 5}}}, {D::RIGHT, D::LEFT}, {}, 1, {false, false}},
+        {"swap of length-2 heads", {{{5, 5}, {4, 5}}, {{6, 5}, {7, 5}}}, {D::RIGHT, D::LEFT}, {}, 1, {false, false}},
+        {"head into body", {{{5, 5}, {5, 6}, {5, 7}}, {{4, 6}}}, {D::UP, D::RIGHT}, {}, 1, {true, false}},
+        {"follow a moving tail", {{{5, 5}, {5, 6}, {5, 7}}, {{4, 7}}}, {D::UP, D::RIGHT}, {}, 1, {true, true}},
+        // 第 1 帧吃到食物的蛇第 2 帧蛇尾不动，跟进蛇尾的蛇撞上
+        {"follow a growing tail", {{{5, 5}, {5, 6}, {5, 7}}, {{3, 6}}}, {D::UP, D::RIGHT}, {{5, 4}}, 2,
+         {true, false}},
+        // 吃到食物的那一帧蛇尾照常让出
+        {"follow a tail while eating", {{{5, 5}, {5, 6}, {5, 7}}, {{4, 7}}}, {D::UP, D::RIGHT}, {{5, 4}}, 1,
+         {true, true}},
+        {"chase in a line", {{{5, 5}}, {{4, 5}}, {{3, 5}}}, {D::RIGHT, D::RIGHT, D::RIGHT}, {}, 1, {true, true, true}},
+    };
+
+    int failures = 0;
+    for (const auto& scenario : scenarios) {
+        if (filter != nullptr && std::strstr(scenario.name, filter) == nullptr) continue;
+        bool ok = runArenaScenario(scenario);
+        failures += ok ? 0 : 1;
+        std::printf("%s arena: %s\n", ok ? "PASS " : "FAIL ", scenario.name);
+    }
+    return failures;
+}
+
+// 存档的固定局面：从新对局的状态改出蛇身、方向、食物和障碍物，推进若干帧得到指定的结局
+struct SaveScenario {
+    const char* name;
+    Game::Outcome outcome;
+    int size;                                         // 棋盘边长
+    std::vector<std::pair<int, int>> body;            // 从头到尾，为空时保持开局的蛇
+    Direction direction;
+    std::pair<int, int> food;
+    std::vector<std::pair<int, int>> obstacles;
+    int ticks;
+};
+
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// 按结局写出存档、读回另一局再写出，两次的文件应逐字节相同
+bool runSaveScenario(const SaveScenario& scenario, const std::string& filename) {
+    GameConfig config;
+    config.board = BoardSize(scenario.size, scenario.size);
+    config.difficulty = Game::Difficulty::EASY;
+    config.seed = 1;
+    Game game(config);
+    if (!scenario.body.empty()) {
+        GameState state;
+        game.captureState(state);
+        state.body = scenario.body;
+        state.direction = static_cast<std::uint8_t>(scenario.direction);
+        state.food = scenario.food;
+        state.obstacles = scenario.obstacles;
+        if (!game.restoreState(state)) return false;
+    }
+    for (int t = 0; t < scenario.ticks && !game.isGameOver(); ++t) {
+        game.update();
+    }
+    if (game.getOutcome() != scenario.outcome || !game.saveGame(filename)) return false;
+    std::string saved = readFile(filename);
+
+    Game loaded(config);
+    if (!loaded.loadGame(filename) || loaded.getOutcome() != scenario.outcome) return false;
+    return loaded.saveGame(filename) && readFile(filename) == saved;
+}
+
+// 读档时对蛇身的检查：相邻两节须相邻，只有蛇尾可以重合
+struct BodyScenario {
+    const char* name;
+    std::vector<std::pair<int, int>> body;
+    bool accepted;
+};
+
+bool runBodyScenario(const BodyScenario& scenario) {
+    GameConfig config;
+    config.difficulty = Game::Difficulty::EASY;
+    config.seed = 1;
+    Game game(config);
+    GameState state;
+    game.captureState(state);
+    state.body = scenario.body;
+    state.direction = static_cast<std::uint8_t>(Direction::RIGHT);
+    state.food = {3, 3};
+    return game.restoreState(state) == scenario.accepted;
+}
+
+// 8x8 棋盘内圈 6x6 格子的蛇形顺序，食物只在内圈生成
+std::vector<std::pair<int, int>> innerSerpentine() {
+    std::vector<std::pair<int, int>> cells;
+    for (int y = 1; y <= 6; ++y) {
+        for (int i = 0; i < 6; ++i) {
+            cells.push_back({y % 2 == 1 ? 1 + i : 6 - i, y});
+        }
+    }
+    return cells;
+}
+
+int checkSaves(const char* filter) {
+    using D = Direction;
+    // 内圈只剩第一格是空的，蛇尾有一节待长出的重叠节（这一帧蛇尾不让出格子），
+    // 蛇头吃到那里的食物后无处生成新食物
+    std::vector<std::pair<int, int>> filled = innerSerpentine();
+    std::pair<int, int> lastFood = filled.front();
+    filled.erase(filled.begin());
+    filled.push_back(filled.back());
+
+    const std::vector<SaveScenario> scenarios = {
+        {"playing", Game::Outcome::PLAYING, 20, {}, D::RIGHT, {0, 0}, {}, 3},
+        {"won", Game::Outcome::WON, 8, filled, D::LEFT, lastFood, {}, 1},
+        {"hit wall", Game::Outcome::HIT_WALL, 20, {{19, 5}, {18, 5}, {17, 5}}, D::RIGHT, {3, 3}, {}, 1},
+        {"hit wall at the top", Game::Outcome::HIT_WALL, 20, {{5, 0}, {5, 1}}, D::UP, {3, 3}, {}, 1},
+        {"hit self", Game::Outcome::HIT_SELF, 20, {{5, 5}, {5, 6}, {6, 6}, {6, 5}, {6, 4}}, D::RIGHT, {3, 3}, {}, 1},
+        {"hit obstacle", Game::Outcome::HIT_OBSTACLE, 20, {{7, 5}, {6, 5}, {5, 5}}, D::RIGHT, {3, 3}, {{8, 5}}, 1},
+    };
+
+    const std::vector<BodyScenario> bodies = {
+        {"contiguous body", {{7, 5}, {6, 5}, {6, 6}}, true},
+        {"repeated tail", {{7, 5}, {6, 5}, {6, 5}, {6, 5}}, true},
+        {"gap in body", {{7, 5}, {6, 5}, {4, 5}}, false},
+        {"diagonal step", {{7, 5}, {6, 6}}, false},
+        {"repeat before tail", {{7, 5}, {7, 5}, {6, 5}}, false},
+    };
+
+    const std::string filename = "snake-tests.snake";
+    int failures = 0;
+    for (const auto& scenario : scenarios) {
+        if (filter != nullptr && std::strstr(scenario.name, filter) == nullptr) continue;
+        bool ok = runSaveScenario(scenario, filename);
+        failures += ok ? 0 : 1;
+        std::printf("%s save: %s\n", ok ? "PASS " : "FAIL ", scenario.name);
+    }
+    std::remove(filename.c_str());
+
+    for (const auto& scenario : bodies) {
+        if (filter != nullptr && std::strstr(scenario.name, filter) == nullptr) continue;
+        bool ok = runBodyScenario(scenario);
+        failures += ok ? 0 : 1;
+        std::printf("%s load: %s\n", ok ? "PASS " : "FAIL ", scenario.name);
+    }
+    return failures;
+}
+
+// HAMILTON 在带障碍物的棋盘上自动寻路：不应撞死，停滞前蛇长应接近回路长度
+bool runHamiltonSeed(std::uint64_t seed) {
+    GameConfig config;
+    config.difficulty = Game::Difficulty::NORMAL;
+    config.alwaysAutoPath = true;
+    config.autoPathStrategy = Game::AutoPathStrategy::HAMILTON;
+    config.seed = seed;
+    Game game(config);
+    const std::uint64_t stallTicks = game.getBoardSize().cellCount() * 4;
+    std::uint64_t lastMeal = 0;
+    int score = game.getScore();
+    while (!game.isGameOver() && game.getTickCount() - lastMeal <= stallTicks) {
+        game.update();
+        if (game.getScore() != score) {
+            score = game.getScore();
+            lastMeal = game.getTickCount();
+        }
+    }
+    if (game.getOutcome() != Game::Outcome::PLAYING && game.getOutcome() != Game::Outcome::WON) return false;
+    int cycleLength = static_cast<int>(game.getBoardSize().cellCount()) -
+                      static_cast<int>(game.getObstacles().size()) - game.getUncoveredCycleCells();
+    return static_cast<int>(game.getSnake().getBody().size()) * 10 >= cycleLength * 9;
+}
+
+int checkHamilton(const char* filter) {
+    int failures = 0;
+    for (std::uint64_t seed = 1; seed <= 8; ++seed) {
+        std::string name = "hamilton seed " + std::to_string(seed);
+        if (filter != nullptr && std::strstr(name.c_str(), filter) == nullptr) continue;
+        bool ok = runHamiltonSeed(seed);
+        failures += ok ? 0 : 1;
+        std::printf("%s autopilot: %s\n", ok ? "PASS " : "FAIL ", name.c_str());
+    }
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (std::strcmp(arg, "--filter") == 0 && value != nullptr) {
+            filter = value;
+            ++i;
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    int failures = checkArena(filter) + checkSaves(filter) + checkHamilton(filter);
+    std::printf("%d failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -27,6 +27,10 @@ public:
     QAction *actionPause;
     QAction *actionSave;
     QAction *actionLoad;
+    QAction *actionRestore_Autosave;
+    QAction *actionSave_Replay;
+    QAction *actionExport_Input_Latency;
+    QAction *actionLeaderboard;
     QAction *actionExit;
     QAction *actionEasy;
     QAction *actionNormal;
@@ -50,6 +54,14 @@ public:
         actionSave->setObjectName(QString::fromUtf8("actionSave"));
         actionLoad = new QAction(MainWindow);
         actionLoad->setObjectName(QString::fromUtf8("actionLoad"));
+        actionRestore_Autosave = new QAction(MainWindow);
+        actionRestore_Autosave->setObjectName(QString::fromUtf8("actionRestore_Autosave"));
+        actionSave_Replay = new QAction(MainWindow);
+        actionSave_Replay->setObjectName(QString::fromUtf8("actionSave_Replay"));
+        actionExport_Input_Latency = new QAction(MainWindow);
+        actionExport_Input_Latency->setObjectName(QString::fromUtf8("actionExport_Input_Latency"));
+        actionLeaderboard = new QAction(MainWindow);
+        actionLeaderboard->setObjectName(QString::fromUtf8("actionLeaderboard"));
         actionExit = new QAction(MainWindow);
         actionExit->setObjectName(QString::fromUtf8("actionExit"));
         actionEasy = new QAction(MainWindow);
@@ -80,6 +92,10 @@ public:
         menuGame->addSeparator();
         menuGame->addAction(actionSave);
         menuGame->addAction(actionLoad);
+        menuGame->addAction(actionRestore_Autosave);
+        menuGame->addAction(actionSave_Replay);
+        menuGame->addAction(actionExport_Input_Latency);
+        menuGame->addAction(actionLeaderboard);
         menuGame->addSeparator();
         menuGame->addAction(actionExit);
         menuDifficulty->addAction(actionEasy);
@@ -109,6 +125,16 @@ public:
         actionLoad->setText(QCoreApplication::translate("MainWindow", "Load", nullptr));
 #if QT_CONFIG(shortcut)
         actionLoad->setShortcut(QCoreApplication::translate("MainWindow", "Ctrl+L", nullptr));
+#endif // QT_CONFIG(shortcut)
+        actionRestore_Autosave->setText(QCoreApplication::translate("MainWindow", "Restore Autosave", nullptr));
+        actionSave_Replay->setText(QCoreApplication::translate("MainWindow", "Save Replay", nullptr));
+#if QT_CONFIG(shortcut)
+        actionSave_Replay->setShortcut(QCoreApplication::translate("MainWindow", "Ctrl+R", nullptr));
+#endif // QT_CONFIG(shortcut)
+        actionExport_Input_Latency->setText(QCoreApplication::translate("MainWindow", "Export Input Latency", nullptr));
+        actionLeaderboard->setText(QCoreApplication::translate("MainWindow", "Leaderboard", nullptr));
+#if QT_CONFIG(shortcut)
+        actionLeaderboard->setShortcut(QCoreApplication::translate("MainWindow", "Ctrl+B", nullptr));
 #endif // QT_CONFIG(shortcut)
         actionExit->setText(QCoreApplication::translate("MainWindow", "Exit", nullptr));
 #if QT_CONFIG(shortcut)